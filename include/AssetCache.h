@@ -0,0 +1,30 @@
+#ifndef ASSET_CACHE_H
+#define ASSET_CACHE_H
+
+#include <SDL2/SDL.h>
+#include <map>
+#include <utility>
+#include "RenderBackend.h"
+
+// 静态界面资源缓存：渐变背景和面板外观只在首次使用或窗口尺寸变化后烘焙一次，
+// 之后每次绘制只是一次 SDL_RenderCopy
+class AssetCache {
+public:
+    // 整个窗口的深色渐变背景
+    static void renderBackground(RenderBackend* renderer, int width, int height);
+    // 半透明面板（底色 + 边框），按尺寸缓存
+    static void renderPanel(RenderBackend* renderer, const SDL_Rect& rect);
+
+    // 窗口尺寸变化或渲染设备重置时丢弃所有烘焙结果
+    static void invalidate();
+    static void cleanup();
+
+private:
+    static SDL_Texture* background;
+    static int backgroundHeight;
+    static std::map<std::pair<int, int>, SDL_Texture*> panels;
+
+    static SDL_Texture* createTexture(RenderBackend* renderer, int width, int height, const Uint32* pixels);
+};
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef CAMERA_H
+#define CAMERA_H
+
+#include <SDL2/SDL.h>
+
+// 迷宫视图的摄像机：世界坐标以格子为单位。
+// zoom 为 1 时整张迷宫恰好放进视口（与原来的适配布局一致），
+// 放大后平滑跟随目标，并把可见区域换算成格子范围供渲染裁剪
+class Camera {
+public:
+    void setViewport(const SDL_Rect& area);
+    void setWorldSize(int width, int height);
+
+    // 跟随目标（格子坐标，一般取玩家格子中心）
+    void follow(float x, float y);
+    void snapToTarget();
+    // 世界整体平移时（无尽模式滚动）同步移动，避免镜头跳动
+    void translate(float dx, float dy);
+    void update(float deltaTime);
+    // 固定步长更新之间的插值比例（0~1），渲染时在上一步和当前步之间取值
+    void setRenderAlpha(float alpha) { renderAlpha = alpha; }
+
+    void zoomBy(float factor);
+    // 恢复默认缩放：能看清时整张适配，格子过小时放大到最小可读尺寸
+    void resetZoom();
+    bool isFitView() const { return zoom <= 1.0f; }
+
+    float getCellSize() const { return fitCellSize() * zoom; }
+    // 世界原点在屏幕上的位置
+    float getOffsetX() const;
+    float getOffsetY() const;
+
+    // 视口覆盖的格子范围，左上含、右下不含，已裁剪到迷宫内
+    void getVisibleCells(int& firstX, int& firstY, int& lastX, int& lastY) const;
+
+private:
+    SDL_Rect viewport = {0, 0, 1, 1};
+    int worldWidth = 1;
+    int worldHeight = 1;
+    float centerX = 0.5f;
+    float centerY = 0.5f;
+    float targetX = 0.5f;
+    float targetY = 0.5f;
+    float previousX = 0.5f;
+    float previousY = 0.5f;
+    float renderAlpha = 1.0f;
+    float zoom = 1.0f;
+
+    static constexpr float FOLLOW_RATE = 10.0f;     // 跟随速度（每秒）
+    static constexpr float MIN_READABLE_CELL = 8.0f; // 默认缩放下格子的最小像素
+    static constexpr float MAX_CELL_SIZE = 64.0f;    // 放大上限
+
+    float fitCellSize() const;
+    float maxZoom() const;
+    // 视口比迷宫小时把中心限制在迷宫内，否则居中
+    float clampAxis(float center, int worldSize, int viewportSize) const;
+};
+
+#endif
@@ -2,15 +2,26 @@
 #define EFFECTS_H
 
 #include <SDL2/SDL.h>
+#include <cstddef>
+#include "RenderBackend.h"
 
 class Effects {
 public:
-    static void renderBlurPanel(SDL_Renderer* renderer, const SDL_Rect& rect);
-    static void renderGlow(SDL_Renderer* renderer, const SDL_Rect& rect, SDL_Color color);
-    static void renderParticles(SDL_Renderer* renderer);
-    static void renderRoundedRect(SDL_Renderer* renderer, const SDL_Rect& rect, int radius);
-    static void renderWallShadow(SDL_Renderer* renderer, const SDL_Rect& rect);
-    static void renderProgressBar(SDL_Renderer* renderer, const SDL_Rect& rect, float progress);
+    static void renderBlurPanel(RenderBackend* renderer, const SDL_Rect& rect);
+    static void renderGlow(RenderBackend* renderer, const SDL_Rect& rect, SDL_Color color);
+    // 背景粒子：更新按秒计时，渲染整池一次提交
+    static void updateParticles(float deltaTime);
+    static void renderParticles(RenderBackend* renderer);
+    // 圆角用按半径和颜色缓存的抗锯齿纹理绘制，共 1 次填充 + 4 次拷贝
+    static void renderRoundedRect(RenderBackend* renderer, const SDL_Rect& rect, int radius,
+                                  SDL_Color color = {40, 40, 60, 255});
+    static void renderWallShadow(RenderBackend* renderer, const SDL_Rect& rect);
+    static void renderProgressBar(RenderBackend* renderer, const SDL_Rect& rect, float progress);
+    // 释放缓存的纹理，须在渲染器销毁前调用
+    static void cleanup();
+    
+    static constexpr size_t MAX_PARTICLES = 4096;
+    static constexpr size_t AMBIENT_PARTICLES = 50;
 };
 
 #endif 
\ No newline at end of file
@@ -4,12 +4,35 @@
 #include <SDL2/SDL.h>
 #include "Maze.h"
 #include "Player.h"
+#include "PathFinder.h"
+#include "MazePregenerator.h"
+#include "WallGeometry.h"
+#include "Camera.h"
+#include "RenderBackend.h"
+#include "InputRecorder.h"
+#include "MoveLog.h"
+#include "SaveWorker.h"
+#include <map>
 #include <string>
 #include <vector>
 
 // 前向声明
 class TextRenderer;
 
+// 帧率控制方式
+enum class FramePacing {
+    VSYNC,      // 跟随显示器刷新（默认）
+    UNCAPPED,   // 不限帧率
+    CAPPED      // 按 targetFps 睡眠限帧
+};
+
+// 渲染后端
+enum class RenderBackendType {
+    SDL,        // 直接绘制（默认）
+    COUNTING,   // 正常绘制，同时统计每帧绘制调用，显示在左侧面板
+    NULL_OUTPUT // 丢弃所有绘制只做统计，用于测量渲染路径的 CPU 开销
+};
+
 enum class GameState {
     MENU,           // 主菜单
     LEVEL_SELECT,   // 关卡选择
@@ -19,12 +42,6 @@ enum class GameState {
     LEVEL_COMPLETE // 关卡完成
 };
 
-struct PointCompare {
-    bool operator()(const SDL_Point& a, const SDL_Point& b) const {
-        return a.x < b.x || (a.x == b.x && a.y < b.y);
-    }
-};
-
 class Game {
 public:
     Game();
@@ -33,11 +50,37 @@ public:
     bool init();
     void run();
     void handleEvents();
-    void update();
+    void update(double deltaTime);
     void render();
     void cleanup();
+    
+    // 须在 init() 之前设置，VSync 在创建渲染器时决定
+    void setFramePacing(FramePacing pacing, int fps = 60);
+    
+    // 须在 init() 之前设置
+    void setRenderBackend(RenderBackendType type);
+    
+    // 无窗口模式：软件渲染到内存表面，不限帧率，按模拟时钟跑 frames 帧后退出。
+    // 须在 init() 之前设置
+    void setHeadless(int frames);
+    // 把第 frame 帧（从 1 开始）保存为 frame_NNNNN.bmp
+    void addFrameDump(int frame);
+    // 启动后直接进入指定关卡
+    void setStartLevel(int level);
+    
+    // 录制本局输入和随机种子，退出时写入 path
+    void recordInput(const std::string& path);
+    // 回放录制文件；fast 为 true 时按模拟时钟尽快运行，否则按实际速度。须在 init() 之前设置
+    void replayInput(const std::string& path, bool fast);
+    
+    // 低功耗模式：暂停装饰粒子，静止界面不再持续重绘
+    void setLowPowerMode(bool enabled);
+    
+    // 最近若干帧的平均帧时间和抖动（标准差），单位毫秒
+    double getAverageFrameTimeMs() const;
+    double getFrameJitterMs() const;
 
-    // 新增状态转换方法
+    // 状态切换：立即切换状态，旧画面快照在之后 TRANSITION_DURATION 秒内淡出
     void transitionToState(GameState newState);
 
 private:
@@ -46,16 +89,97 @@ private:
     
     SDL_Window* window;
     SDL_Renderer* renderer;
+    
+    // 所有绘制经由 backend 提交，renderer 只用来创建纹理；
+    // 统计模式下 drawCounter 指向同一个后端，否则为空
+    RenderBackend* backend;
+    CountingRenderBackend* drawCounter;
+    RenderBackendType backendType;
+    void printRenderStats() const;
+    
+    // 无窗口模式和快速回放：每帧固定推进 SIMULATED_FRAME_TIME，随机数种子固定，输出可复现
+    bool headless;
+    int headlessFrames;
+    SDL_Surface* headlessSurface;
+    std::vector<int> frameDumps;
+    int startLevel;
+    static constexpr double SIMULATED_FRAME_TIME = 1.0 / 60.0;
+    static constexpr unsigned DETERMINISTIC_SEED = 20240601;
+    void dumpFrame(int frame);
+    
+    // 输入录制与回放，事件时间戳为 simulationStep（已执行的固定步长更新次数）
+    InputRecorder* inputRecorder;
+    bool recordingInput;
+    bool replayingInput;
+    bool fastReplay;
+    std::string inputPath;
+    uint64_t simulationStep;
+    void feedReplayEvents();
+    // 随机迷宫的种子：回放时取录制的种子，录制时记下实际用到的种子
+    bool takeReplaySeed(uint32_t& seed);
+    void recordSeed(uint32_t seed);
+    // 无窗口和回放时不读写存档：进度取默认值或录制文件里的值，结果不受本机存档影响，也不会覆盖存档
+    bool persistProgress;
+    
+    // 鼠标状态由事件维护，回放时不受真实鼠标影响
+    int mouseX;
+    int mouseY;
+    bool mouseLeftDown;
+    
+    // 迷宫静态层缓存（地面、墙壁、阴影、终点）
+    SDL_Texture* mazeLayerTexture;
+    bool mazeLayerDirty;
+    
+    // 每帧先画进 frameTexture；切换状态时与 snapshotTexture 交换，
+    // 上一帧画面就成了旧状态的快照
+    SDL_Texture* frameTexture;
+    SDL_Texture* snapshotTexture;
+    int frameTextureWidth;
+    int frameTextureHeight;
+    bool transitionActive;
+    double transitionTime;
+    static constexpr double TRANSITION_DURATION = 0.3;
+    bool ensureFrameTextures();
+    void releaseFrameTextures();
+    void renderFrame();
+    void prepareStateAssets(GameState state);
+    
+    // 空闲检测：画面失效或有动画时才渲染，否则阻塞等待事件
+    bool needsRedraw;
+    bool lowPowerMode;
+    static constexpr Uint32 IDLE_WAIT_MS = 500;
+    bool isAnimating() const;
+    void dispatchEvent(const SDL_Event& event);
+    
+    // 合并后的墙体/地面矩形，以及每帧复用的像素矩形缓冲区
+    WallGeometry wallGeometry;
+    std::vector<SDL_Rect> floorPixelRects;
+    std::vector<SDL_Rect> wallPixelRects;
+    std::vector<SDL_Rect> shadowPixelRects;
+    
+    // 小地图：每格一个像素的流式纹理，移动时只更新新访问的像素
+    SDL_Texture* miniMapTexture;
+    bool miniMapDirty;
+    std::vector<Uint32> miniMapPixels;
+    std::vector<uint8_t> visitedCells;
+    
+    // 迷宫视图的摄像机（跟随、缩放、可见范围裁剪）
+    Camera camera;
     GameState currentState;
     
     // 游戏组件
     Maze* currentMaze;
     Player* player;
+    EllerMazeStream* endlessStream;  // 无尽模式的逐行生成器
+    MazePregenerator* pregenerator;  // 随机挑战的后台预生成队列
+    SaveWorker* saveWorker;          // 后台存档线程
     
     // 游戏数据
     int currentLevel;
     int maxRandomLevel;
     int maxUnlockedLevel;
+    bool randomMode;    // 是否处于随机挑战
+    int randomLevel;    // 当前随机挑战关数
     bool isRunning;
     
     // 事件处理方法
@@ -75,9 +199,18 @@ private:
     // 游戏逻辑方法
     bool loadLevel(int level);
     void generateRandomLevel();
+    static int randomLevelSize(int level);
+    
+    // 无尽模式：迷宫按行流式生成，只保留玩家附近的窗口
+    static constexpr int ENDLESS_WIDTH = 21;
+    static constexpr int ENDLESS_WINDOW_HEIGHT = 31;
+    bool endlessMode;
+    int endlessDepth;   // 已下潜的房间行数
+    void startEndlessMode();
+    void advanceEndless();
     
     // UI 渲染方法
-    void renderButton(SDL_Renderer* renderer, 
+    void renderButton(RenderBackend* renderer, 
                      const std::string& text, 
                      int x, int y, 
                      SDL_Color color);
@@ -117,7 +250,6 @@ private:
     SDL_Rect mazeRenderArea;
     
     // 新增特效相关成员
-    std::vector<SDL_Point> playerTrail;
     SDL_Color currentThemeColor;
     
     // 新增渲染方法
@@ -126,12 +258,11 @@ private:
     void renderControlButton(const std::string& text, const SDL_Rect& rect);
     void renderControlButtons();
     void renderMazeGlow(const SDL_Rect& area);
-    void renderPlayerTrail();
     void renderDynamicLighting();
     
     // 辅助方法
     bool isMouseOver(const SDL_Rect& rect);
-    std::string formatTime(float time);
+    std::string formatTime(double time);
     void updateThemeColor();
     
     // 私有辅助方法
@@ -143,6 +274,18 @@ private:
     void calculateMazeRenderArea();
     void renderGameLeftPanel();
     void renderMaze();
+    void drawMazeGeometry(float offsetX, float offsetY, float cellSize);
+    void drawVisibleCells(int firstX, int firstY, int lastX, int lastY,
+                          float offsetX, float offsetY, float cellSize);
+    void onMazeChanged();
+    void rebuildMiniMap();
+    Uint32 miniMapColorAt(int x, int y) const;
+    void resetLevelView();
+    void scrollVisitedCells(int cellRows);
+    void markVisited(int x, int y);
+    void rebuildMazeLayer();
+    void invalidateMazeLayer();
+    void handleWindowEvent(const SDL_Event& event);
     void loadResources();
     void renderMiniMap();
     void renderGameInfoPanel();
@@ -150,7 +293,6 @@ private:
     void renderButtonGlow(const SDL_Rect& rect);
     
     // 新增渲染方法
-    void renderParticles();
     
     void renderGameInfo();
     
@@ -158,7 +300,42 @@ private:
     
     // 游戏统计
     int moveCount;
-    float gameTime;
+    double gameTime;
+    
+    // 走法记录：本局移动按 2 位打包；每关最佳一局随进度保存，游玩时由幽灵重放
+    struct BestRun {
+        MoveLog moves;
+        double time = 0.0;
+    };
+    MoveLog currentRun;
+    std::map<int, BestRun> bestRuns;
+    int ghostX;
+    int ghostY;
+    size_t ghostStep;   // 幽灵已解码到的步数
+    static constexpr double MIN_GHOST_STEP_TIME = 0.05;
+    void recordCompletedRun();
+    // 每局完成的走法追加到 save/runs.dat
+    void appendRunHistory(int level, const MoveLog& moves, double time);
+    // 只有固定关卡有幽灵，随机、无尽模式以及无窗口和回放时返回 nullptr
+    const BestRun* currentBestRun() const;
+    void resetGhost();
+    void updateGhost();
+    
+    // 固定步长模拟：逻辑按 FIXED_TIMESTEP 推进，渲染按 framePacing 节奏
+    static constexpr double FIXED_TIMESTEP = 1.0 / 120.0;
+    static constexpr double MAX_FRAME_TIME = 0.25;  // 卡顿后最多追赶的时间
+    double accumulator;  // 已经过但还没按固定步长模拟的时间
+    FramePacing framePacing;
+    int targetFps;
+    
+    // 帧时间历史（秒），用于统计抖动
+    static constexpr int FRAME_HISTORY = 120;
+    double frameTimes[FRAME_HISTORY];
+    int frameTimeIndex;
+    int frameTimeCount;
+    void recordFrameTime(double seconds);
+    void waitForNextFrame(Uint64 frameStart, Uint64 frequency);
+    int optimalMoves;   // 起点到终点的最短步数，来自距离场
     bool showHint;
     std::vector<SDL_Point> hintPath;
     
@@ -166,6 +343,7 @@ private:
     SDL_Rect retryButton;
     SDL_Rect hintButton;
     
+    PathFinder pathFinder;
     void calculateHintPath();
     SDL_Rect backButton;
 };
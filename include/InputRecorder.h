@@ -0,0 +1,75 @@
+#ifndef INPUT_RECORDER_H
+#define INPUT_RECORDER_H
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 输入录制与回放。录制时按模拟步数（已执行的固定步长更新次数）记下每个输入事件，
+// 以及每局随机迷宫用到的种子，存成紧凑的二进制文件；文件头带上录制开始时的解锁进度。
+// 回放时在相同的步数把事件重新交给事件处理函数，种子按录制顺序取出，
+// 迷宫和操作都与录制时一致，不受回放机器上存档的影响
+class InputRecorder {
+public:
+    // 只录制会影响游戏的输入：键盘、鼠标和退出
+    static bool isRecordable(const SDL_Event& event);
+
+    void recordEvent(uint64_t step, const SDL_Event& event);
+    void recordSeed(uint64_t step, uint32_t seed);
+    // 录制开始时已解锁的最高关卡，决定关卡选择界面哪些点击有效
+    void setStartUnlockedLevel(int level) { startUnlockedLevel = level; }
+    int getStartUnlockedLevel() const { return startUnlockedLevel; }
+    bool save(const std::string& path) const;
+
+    bool load(const std::string& path);
+    // 取出下一个不晚于 step 的事件，没有则返回 false
+    bool nextEvent(uint64_t step, SDL_Event& event);
+    // 按录制顺序取下一个种子，用完返回 false
+    bool nextSeed(uint32_t& seed);
+    bool finished() const { return eventCursor >= events.size(); }
+
+    size_t getEventCount() const { return events.size(); }
+    size_t getSeedCount() const { return seeds.size(); }
+
+private:
+    enum class RecordType : uint8_t {
+        KEY_DOWN,
+        KEY_UP,
+        MOUSE_DOWN,
+        MOUSE_UP,
+        MOUSE_MOTION,
+        MOUSE_WHEEL,
+        QUIT,
+        SEED
+    };
+
+    // 各类型用到的字段：键盘 a=sym b=mod c=repeat；鼠标按键 a=button b=x c=y；
+    // 移动 a=x b=y c=按键状态；滚轮 a=x b=y
+    struct Record {
+        uint64_t step;
+        RecordType type;
+        int32_t a;
+        int32_t b;
+        int32_t c;
+    };
+
+    struct Seed {
+        uint64_t step;
+        uint32_t value;
+    };
+
+    std::vector<Record> events;
+    std::vector<Seed> seeds;
+    size_t eventCursor = 0;
+    size_t seedCursor = 0;
+    int startUnlockedLevel = 1;
+
+    // 每种记录带几个整数字段，未知类型返回 -1
+    static int fieldCount(uint8_t type);
+
+    static constexpr char MAGIC[4] = {'M', 'Z', 'R', 'P'};
+    static constexpr uint8_t VERSION = 2;
+};
+
+#endif
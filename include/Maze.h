@@ -4,6 +4,11 @@
 #include <SDL2/SDL.h>
 #include <vector>
 #include <string>
+#include <cstdint>
+#include <cstddef>
+#include <bit>
+#include "MazeGenerator.h"
+#include "RenderBackend.h"
 
 class Maze {
 public:
@@ -12,17 +17,67 @@ public:
 
     // 迷宫生成和加载
     bool loadLevel(int level);
-    void generateRandomMaze(int size);
+    void generateRandomMaze(int size, MazeAlgorithm algorithm = MazeAlgorithm::DFS);
+    void generateRandomMaze(int size, MazeAlgorithm algorithm, uint32_t seed);
+    // 无尽模式：width 列宽、windowHeight 行高的窗口，由 stream 持续补充新行
+    void generateEndlessWindow(int width, int windowHeight, EllerMazeStream& stream);
+    uint32_t getSeed() const { return seed; }
     
     // 渲染
-    void render(SDL_Renderer* renderer);
+    void render(RenderBackend* renderer);
     
     // 迷宫属性
     int getWidth() const { return width; }
     int getHeight() const { return height; }
+    SDL_Point getGoalPosition() const { return goalPosition; }
     bool isWall(int x, int y) const;
     bool isGoal(int x, int y) const;
     bool isValidPosition(int x, int y) const;
+    
+    // 修改单个格子，增量更新它和四个邻居的通路掩码
+    void setCell(int x, int y, int type);
+
+    // 方向编号与通路掩码的位一一对应：上、右、下、左
+    enum Direction { DIR_UP = 0, DIR_RIGHT = 1, DIR_DOWN = 2, DIR_LEFT = 3 };
+    static constexpr int DIRECTION_DX[4] = {0, 1, 0, -1};
+    static constexpr int DIRECTION_DY[4] = {-1, 0, 1, 0};
+    static int directionFromDelta(int dx, int dy);
+
+    // 线性格子索引（包含一圈哨兵墙），以下接口不做边界检查，
+    // 调用方需保证坐标位于迷宫内部
+    int getCellCount() const { return stride * (height + 2); }
+    int toIndex(int x, int y) const { return (y + 1) * stride + (x + 1); }
+    int indexToX(int index) const { return index % stride - 1; }
+    int indexToY(int index) const { return index / stride - 1; }
+    int neighborIndex(int index, int dir) const { return index + neighborOffsets[dir]; }
+    bool isWallAt(int index) const { return testWall(static_cast<size_t>(index)); }
+    uint8_t openDirectionsAt(int index) const {
+        return (openMasks[index >> 1] >> ((index & 1) << 2)) & 0x0F;
+    }
+    uint8_t openDirections(int x, int y) const { return openDirectionsAt(toIndex(x, y)); }
+    bool canMove(int x, int y, int dir) const { return (openDirections(x, y) >> dir) & 1u; }
+    
+    // 遍历某格所有可通行的邻居：fn(neighborIndex, dir)
+    template <typename Fn>
+    void forEachOpenNeighbor(int index, Fn&& fn) const {
+        unsigned mask = openDirectionsAt(index);
+        while (mask) {
+            int dir = std::countr_zero(mask);
+            mask &= mask - 1;
+            fn(index + neighborOffsets[dir], dir);
+        }
+    }
+
+    size_t countOpenCells() const;
+
+    // 以终点为根的距离场：加载或生成迷宫后做一次反向 BFS，
+    // 之后提示路径只需沿距离递减的方向贪心前进
+    void buildDistanceField();
+    bool hasDistanceField() const { return distanceFieldValid; }
+    // 从 (x, y) 走到终点的最短路径（不含起点，含终点），不可达时返回 false
+    bool traceToGoal(int x, int y, std::vector<SDL_Point>& path) const;
+    // 到终点的最短步数，不可达时返回 -1；耗时与路径长度成正比
+    int getDistanceToGoal(int x, int y) const;
 
     // 将常量定义改为 static constexpr
     static constexpr int WALL = 1;
@@ -30,14 +85,41 @@ public:
     static constexpr int GOAL = 2;
 
 private:
-    std::vector<std::vector<int>> mazeData;
+    friend class MazeGenerator;
+    
+    // 墙体位图：行优先连续存储，每格 1 位（1 = 墙），四周多一圈哨兵墙，
+    // 终点单独记录坐标
+    std::vector<uint64_t> wallBits;
+    // 每格 4 位的通路掩码，两格共用一个字节
+    std::vector<uint8_t> openMasks;
     int width;
     int height;
+    int stride;
+    int neighborOffsets[4];
     SDL_Point goalPosition;
+    uint32_t seed;
+    
+    // 距离场每格 2 位，存到终点的 BFS 距离模 3。相邻格的距离最多相差 1，
+    // 所以模 3 足以分辨出"更近一步"的邻居；UNREACHABLE 表示不可达
+    std::vector<uint8_t> distanceCodes;
+    bool distanceFieldValid;
+    static constexpr uint8_t UNREACHABLE = 3;
+    uint8_t distanceCodeAt(int index) const {
+        return (distanceCodes[index >> 2] >> ((index & 3) << 1)) & 3u;
+    }
+    void storeDistanceCode(int index, uint8_t code);
+    int stepTowardGoal(int index) const;
     
-    // 迷宫生成算法
-    void generateMazeUsingDFS(int size);
-    void carvePassages(int x, int y);
+    size_t cellIndex(int x, int y) const { return static_cast<size_t>(toIndex(x, y)); }
+    bool testWall(size_t index) const {
+        return (wallBits[index >> 6] >> (index & 63)) & 1u;
+    }
+    void setWall(int x, int y, bool wall);
+    void resetGrid(int newWidth, int newHeight, bool fillWall);
+    void scrollUp(int cellRows);
+    uint8_t computeOpenMask(int index) const;
+    void storeOpenMask(int index, uint8_t mask);
+    void rebuildOpenMasks();
     
     // 文件操作
     bool loadFromFile(const std::string& filename);
@@ -0,0 +1,92 @@
+#ifndef MAZE_GENERATOR_H
+#define MAZE_GENERATOR_H
+
+#include <memory>
+#include <random>
+#include <vector>
+#include <cstdint>
+
+class Maze;
+
+// 可选的迷宫生成算法
+enum class MazeAlgorithm {
+    DFS,                // 深度优先回溯
+    KRUSKAL,            // 并查集 Kruskal
+    PRIM,               // 随机 Prim
+    WILSON,             // Wilson 环擦除随机游走（均匀生成树）
+    ELLER,              // Eller 逐行生成
+    RECURSIVE_DIVISION  // 递归分割
+};
+
+// 生成器接口：房间位于奇数坐标 (2i+1, 2j+1)，生成器只决定房间之间的通道。
+// 调用前迷宫已按尺寸填满墙，生成结束后由 Maze 重建通路掩码。
+class MazeGenerator {
+public:
+    virtual ~MazeGenerator() = default;
+
+    virtual void generate(Maze& maze, std::mt19937& rng) = 0;
+
+    static std::unique_ptr<MazeGenerator> create(MazeAlgorithm algorithm);
+
+protected:
+    // 房间网格尺寸
+    static int roomColumns(const Maze& maze);
+    static int roomRows(const Maze& maze);
+
+    // 直接写入迷宫的墙体位图（不维护通路掩码）
+    static void openRoom(Maze& maze, int roomX, int roomY);
+    static bool isRoomOpen(const Maze& maze, int roomX, int roomY);
+    static void setPassage(Maze& maze, int roomX, int roomY, int dir, bool open);
+    static void scrollRows(Maze& maze, int cellRows);
+    static void finishEditing(Maze& maze);
+};
+
+// Eller 算法的逐行状态机，内存只与行宽有关。
+// 批量生成器和无尽模式都用它一次产出一行房间的连接关系。
+class EllerRowGenerator {
+public:
+    void reset(int columns);
+
+    // 生成下一行：rightOpen[c] 表示房间 c 与 c+1 相通，
+    // downOpen[c] 表示房间 c 与下一行同列房间相通。
+    // lastRow 为 true 时合并所有集合且不再向下连通。
+    void nextRow(std::mt19937& rng, bool lastRow,
+                 std::vector<uint8_t>& rightOpen, std::vector<uint8_t>& downOpen);
+
+    int getColumns() const { return columns; }
+
+private:
+    int columns = 0;
+    std::vector<int> rowSet;       // 当前行每列所属集合
+    std::vector<int> parent;       // 集合标签上的并查集
+    std::vector<int> remap;        // 行末压缩标签用
+    std::vector<int> memberCount;  // 每个集合在本行的房间数
+    std::vector<int> pickedColumn; // 每个集合蓄水池抽样选中的列
+    std::vector<uint8_t> hasDown;  // 每个集合是否已有向下的通道
+
+    int find(int label);
+};
+
+// 无尽模式：用 Eller 算法按需逐行生成，迷宫对象只保留一个固定高度的窗口。
+// 玩家向下前进时窗口上移，移出的行被丢弃，内存占用与前进距离无关。
+class EllerMazeStream : public MazeGenerator {
+public:
+    explicit EllerMazeStream(uint32_t seed);
+
+    // 填满整个窗口；窗口最底下的墙线上会预留通往后续行的缺口
+    void generate(Maze& maze, std::mt19937& rng) override;
+    void generate(Maze& maze) { generate(maze, rng); }
+
+    // 窗口整体上移 count 行房间并在底部生成新行，返回上移的格子行数
+    int advance(Maze& maze, int count);
+
+private:
+    std::mt19937 rng;
+    EllerRowGenerator eller;
+    std::vector<uint8_t> rightOpen;
+    std::vector<uint8_t> downOpen;
+
+    void emitRow(Maze& maze, int roomY);
+};
+
+#endif
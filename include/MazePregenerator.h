@@ -0,0 +1,63 @@
+#ifndef MAZE_PREGENERATOR_H
+#define MAZE_PREGENERATOR_H
+
+#include "Maze.h"
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+// 随机挑战的后台预生成队列：工作线程为接下来要用到的尺寸各备好几份迷宫
+// （距离场也已算好），渲染线程取用时只需交换指针
+class MazePregenerator {
+public:
+    explicit MazePregenerator(size_t targetDepth = 2);
+    ~MazePregenerator();
+
+    void start();
+    void stop();
+
+    // 声明接下来会用到的尺寸；不再需要的尺寸会被丢弃
+    void setUpcomingSizes(const std::vector<int>& sizes);
+
+    // 取一个现成的迷宫，队列为空时返回 nullptr，由调用方同步生成
+    std::unique_ptr<Maze> take(int size);
+
+    // 调参用的统计数据
+    void setTargetDepth(size_t depth);
+    size_t getTargetDepth() const;
+    size_t getQueueDepth() const;
+    size_t getQueueDepth(int size) const;
+    double getLastLatencyMs() const;
+    double getAverageLatencyMs() const;
+    size_t getHitCount() const;
+    size_t getMissCount() const;
+
+private:
+    void workerLoop();
+    int pickSizeToGenerate() const;
+
+    std::thread worker;
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    bool running;
+
+    std::vector<int> upcomingSizes;
+    std::map<int, std::deque<std::unique_ptr<Maze>>> readyMazes;
+    size_t targetDepth;
+
+    // 工作线程独占的种子发生器
+    std::mt19937 seeder;
+
+    double lastLatencyMs;
+    double totalLatencyMs;
+    size_t generatedCount;
+    size_t hitCount;
+    size_t missCount;
+};
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef MOVE_LOG_H
+#define MOVE_LOG_H
+
+#include "Maze.h"
+#include <cstdint>
+#include <cstddef>
+#include <iosfwd>
+#include <vector>
+
+// 一局的移动序列。起点固定为 (1,1)，每步只需记 Maze::Direction，按 2 位打包，
+// 每字节 4 步（低位在前）；顺序解码每步只是一次移位
+class MoveLog {
+public:
+    void push(Maze::Direction direction);
+    Maze::Direction at(size_t index) const;
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    void clear();
+
+    // 打包后占用的字节数
+    size_t byteSize() const { return bytes.size(); }
+
+    // 二进制格式：步数（uint32）+ 打包字节
+    void write(std::ostream& out) const;
+    bool read(std::istream& in);
+
+private:
+    std::vector<uint8_t> bytes;
+    size_t count = 0;
+
+    // 防止损坏的存档申请过多内存
+    static constexpr uint32_t MAX_MOVES = 1 << 24;
+};
+
+#endif
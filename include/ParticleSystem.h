@@ -0,0 +1,42 @@
+#ifndef PARTICLE_SYSTEM_H
+#define PARTICLE_SYSTEM_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include <cstddef>
+#include "RenderBackend.h"
+
+// 固定容量的粒子池，按属性分数组存储（SoA）。
+// 更新是几条可向量化的直线循环，死亡粒子用末尾元素填补（不保持顺序），
+// 渲染时整池一次 SDL_RenderGeometry 提交
+class ParticleSystem {
+public:
+    explicit ParticleSystem(size_t capacity);
+
+    // 池满时返回 false；速度单位为像素/秒，寿命单位为秒
+    bool spawn(float x, float y, float vx, float vy, float lifetime);
+    void update(float deltaTime);
+    // 每个粒子画成 1 像素方块，透明度随剩余寿命衰减
+    void render(RenderBackend* renderer, SDL_Color color);
+    void clear() { count = 0; }
+
+    size_t size() const { return count; }
+    size_t capacity() const { return maxCount; }
+
+private:
+    size_t maxCount;
+    size_t count = 0;
+
+    std::vector<float> posX, posY;
+    std::vector<float> velX, velY;
+    std::vector<float> life;      // 剩余寿命比例，1 → 0
+    std::vector<float> decay;     // 每秒减少的寿命比例
+
+    // 渲染缓冲区：顶点每帧重写，索引只在构造时生成
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+
+    void removeDead();
+};
+
+#endif
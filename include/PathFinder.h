@@ -0,0 +1,31 @@
+#ifndef PATH_FINDER_H
+#define PATH_FINDER_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Maze.h"
+#include "RingQueue.h"
+
+// 基于线性格子索引的 BFS 寻路器，缓冲区按关卡分配一次后反复使用
+class PathFinder {
+public:
+    // 按迷宫尺寸准备缓冲区，尺寸不变时直接复用
+    void reset(const Maze& maze);
+    
+    // 计算 start 到 goal 的最短路径（不含起点，含终点），不可达时返回 false
+    bool findPath(const Maze& maze, SDL_Point start, SDL_Point goal,
+                  std::vector<SDL_Point>& path);
+
+private:
+    // 每格一个字节：高 6 位是搜索轮次，低 2 位是进入该格的方向。
+    // 轮次不匹配即视为未访问，因此只有轮次回绕时才需要清空
+    std::vector<uint8_t> visitInfo;
+    uint8_t currentStamp = 0;
+    RingQueue<int32_t> queue;
+    
+    static constexpr uint8_t MAX_STAMP = 63;
+};
+
+#endif
@@ -9,7 +9,7 @@ public:
     Player() : x(1), y(1), currentMaze(nullptr) {}
     
     void handleInput(const SDL_Event& event);
-    void render(SDL_Renderer* renderer);
+    void render(RenderBackend* renderer);
     
     // 位置相关
     int getX() const { return x; }
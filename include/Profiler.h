@@ -0,0 +1,112 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <SDL2/SDL.h>
+#include "RenderBackend.h"
+
+// 帧内分区计时。用 CMake 选项 ENABLE_PROFILER 打开（定义 MAZE_ENABLE_PROFILER），
+// 关闭时 PROFILE_SCOPE 展开为空、Profiler 的接口都是空内联函数，没有任何开销。
+//
+// 每个 PROFILE_SCOPE 在析构时把一条样本写进无锁环形缓冲区；
+// endFrame 把本帧的样本按分区累加，保留最近若干帧用于统计 p50/p99，
+// F3 切换屏幕叠加显示，退出时把缓冲区里的样本导出为 Chrome trace_event JSON
+#ifdef MAZE_ENABLE_PROFILER
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+class Profiler {
+public:
+    // name 必须是字符串字面量（只保存指针）
+    static void record(const char* name, Uint64 start, Uint64 end);
+
+    // 每次提交画面后调用一次，结算本帧各分区耗时
+    static void endFrame();
+
+    static void toggleOverlay() { overlayVisible = !overlayVisible; }
+    static void renderOverlay(RenderBackend* renderer);
+
+    // 导出 chrome://tracing / Perfetto 可读的 JSON
+    static bool writeTrace(const char* path);
+
+private:
+    static constexpr size_t RING_SIZE = 1 << 16;   // 必须是 2 的幂
+    static constexpr size_t MAX_ZONES = 16;
+    static constexpr size_t HISTORY_FRAMES = 240;
+
+    struct Sample {
+        const char* name = nullptr;
+        Uint64 start = 0;
+        Uint64 end = 0;
+        uint32_t thread = 0;
+    };
+
+    // seq 在样本写完后才发布，读者据此跳过正在写或已被覆盖的槽位
+    struct Slot {
+        std::atomic<uint64_t> seq{0};
+        Sample sample;
+    };
+
+    struct Zone {
+        const char* name = nullptr;
+        Uint64 frameTicks = 0;     // 本帧累计
+        bool touched = false;
+        float history[HISTORY_FRAMES] = {};
+        size_t historyCount = 0;
+        size_t historyCursor = 0;
+        float p50 = 0.0f;
+        float p99 = 0.0f;
+    };
+
+    static Slot ring[RING_SIZE];
+    static std::atomic<uint64_t> writeIndex;
+    static uint64_t readIndex;
+
+    static Zone zones[MAX_ZONES];
+    static size_t zoneCount;
+    static bool overlayVisible;
+    // 大于 0 时本线程的样本直接丢弃，叠加层自身的绘制不计入它显示的分区
+    static thread_local int suspendDepth;
+
+    // 读出第 index 条样本；槽位已被覆盖或正在写入时返回 false
+    static bool readSample(uint64_t index, Sample& out);
+    static Zone* findZone(const char* name);
+    static void updatePercentiles(Zone& zone);
+    static uint32_t currentThread();
+};
+
+// 作用域计时器：构造时取时间戳，析构时提交样本
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* zoneName) :
+        name(zoneName), start(SDL_GetPerformanceCounter()) {}
+    ~ProfileScope() { Profiler::record(name, start, SDL_GetPerformanceCounter()); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* name;
+    Uint64 start;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(name)
+
+#else
+
+class Profiler {
+public:
+    static void endFrame() {}
+    static void toggleOverlay() {}
+    static void renderOverlay(RenderBackend*) {}
+    static bool writeTrace(const char*) { return false; }
+};
+
+#define PROFILE_SCOPE(name) ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,167 @@
+#ifndef RENDER_BACKEND_H
+#define RENDER_BACKEND_H
+
+#include <SDL2/SDL.h>
+#include <memory>
+
+// 一帧的绘制统计
+struct RenderStats {
+    int drawCalls = 0;          // 提交的绘制命令数（FillRects 等批量调用算一次）
+    int stateChanges = 0;       // 颜色、混合模式、渲染目标、裁剪区域真正改变的次数
+    int redundantStates = 0;    // 设置成与当前相同值的次数，可以合批省掉
+    long long pixelsFilled = 0; // 按目标矩形面积估算的填充像素数
+};
+
+// 渲染命令接口。所有绘制都经由它提交，便于统计调用次数或在无窗口时跳过实际绘制。
+// 纹理等资源仍由 SDL 渲染器创建：getSDLRenderer() 为空时调用方应走无纹理的回退路径
+class RenderBackend {
+public:
+    virtual ~RenderBackend() = default;
+
+    virtual SDL_Renderer* getSDLRenderer() const = 0;
+    virtual void getOutputSize(int* width, int* height) const = 0;
+
+    virtual void setDrawColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a) = 0;
+    virtual void setDrawBlendMode(SDL_BlendMode mode) = 0;
+    virtual void setTarget(SDL_Texture* texture) = 0;
+    virtual SDL_Texture* getTarget() const = 0;
+    virtual void setClipRect(const SDL_Rect* rect) = 0;
+
+    virtual void clear() = 0;
+    virtual void fillRect(const SDL_Rect* rect) = 0;
+    virtual void fillRects(const SDL_Rect* rects, int count) = 0;
+    virtual void drawRect(const SDL_Rect* rect) = 0;
+    virtual void drawLine(int x1, int y1, int x2, int y2) = 0;
+    virtual void drawPoint(int x, int y) = 0;
+    virtual void copy(SDL_Texture* texture, const SDL_Rect* source, const SDL_Rect* dest) = 0;
+    virtual void copyEx(SDL_Texture* texture, const SDL_Rect* source, const SDL_Rect* dest,
+                        double angle, const SDL_Point* center, SDL_RendererFlip flip) = 0;
+    virtual void geometry(SDL_Texture* texture, const SDL_Vertex* vertices, int vertexCount,
+                          const int* indices, int indexCount) = 0;
+
+    // 提交一帧
+    virtual void present() = 0;
+};
+
+// 默认后端：直接转发给 SDL
+class SDLRenderBackend : public RenderBackend {
+public:
+    explicit SDLRenderBackend(SDL_Renderer* sdlRenderer) : renderer(sdlRenderer) {}
+
+    SDL_Renderer* getSDLRenderer() const override { return renderer; }
+    void getOutputSize(int* width, int* height) const override;
+
+    void setDrawColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a) override;
+    void setDrawBlendMode(SDL_BlendMode mode) override;
+    void setTarget(SDL_Texture* texture) override;
+    SDL_Texture* getTarget() const override;
+    void setClipRect(const SDL_Rect* rect) override;
+
+    void clear() override;
+    void fillRect(const SDL_Rect* rect) override;
+    void fillRects(const SDL_Rect* rects, int count) override;
+    void drawRect(const SDL_Rect* rect) override;
+    void drawLine(int x1, int y1, int x2, int y2) override;
+    void drawPoint(int x, int y) override;
+    void copy(SDL_Texture* texture, const SDL_Rect* source, const SDL_Rect* dest) override;
+    void copyEx(SDL_Texture* texture, const SDL_Rect* source, const SDL_Rect* dest,
+                double angle, const SDL_Point* center, SDL_RendererFlip flip) override;
+    void geometry(SDL_Texture* texture, const SDL_Vertex* vertices, int vertexCount,
+                  const int* indices, int indexCount) override;
+
+    void present() override;
+
+private:
+    SDL_Renderer* renderer;
+};
+
+// 空后端：丢弃所有绘制，只记住渲染目标和输出尺寸，用来单独测量渲染路径的 CPU 开销。
+// 资源仍在 sdlRenderer 上创建（可以为空，此时各模块走无纹理路径）
+class NullRenderBackend : public RenderBackend {
+public:
+    NullRenderBackend(SDL_Renderer* sdlRenderer, int width, int height) :
+        renderer(sdlRenderer), outputWidth(width), outputHeight(height) {}
+
+    SDL_Renderer* getSDLRenderer() const override { return renderer; }
+    void getOutputSize(int* width, int* height) const override;
+
+    void setDrawColor(Uint8, Uint8, Uint8, Uint8) override {}
+    void setDrawBlendMode(SDL_BlendMode) override {}
+    void setTarget(SDL_Texture* texture) override { target = texture; }
+    SDL_Texture* getTarget() const override { return target; }
+    void setClipRect(const SDL_Rect*) override {}
+
+    void clear() override {}
+    void fillRect(const SDL_Rect*) override {}
+    void fillRects(const SDL_Rect*, int) override {}
+    void drawRect(const SDL_Rect*) override {}
+    void drawLine(int, int, int, int) override {}
+    void drawPoint(int, int) override {}
+    void copy(SDL_Texture*, const SDL_Rect*, const SDL_Rect*) override {}
+    void copyEx(SDL_Texture*, const SDL_Rect*, const SDL_Rect*,
+                double, const SDL_Point*, SDL_RendererFlip) override {}
+    void geometry(SDL_Texture*, const SDL_Vertex*, int, const int*, int) override {}
+
+    void present() override {}
+
+private:
+    SDL_Renderer* renderer;
+    int outputWidth;
+    int outputHeight;
+    SDL_Texture* target = nullptr;
+};
+
+// 统计后端：包装另一个后端，逐帧统计绘制调用、状态切换和填充像素。
+// present() 时把本帧结果存入 getLastFrame() 并清零
+class CountingRenderBackend : public RenderBackend {
+public:
+    explicit CountingRenderBackend(std::unique_ptr<RenderBackend> wrapped);
+
+    SDL_Renderer* getSDLRenderer() const override { return inner->getSDLRenderer(); }
+    void getOutputSize(int* width, int* height) const override { inner->getOutputSize(width, height); }
+
+    void setDrawColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a) override;
+    void setDrawBlendMode(SDL_BlendMode mode) override;
+    void setTarget(SDL_Texture* texture) override;
+    SDL_Texture* getTarget() const override { return inner->getTarget(); }
+    void setClipRect(const SDL_Rect* rect) override;
+
+    void clear() override;
+    void fillRect(const SDL_Rect* rect) override;
+    void fillRects(const SDL_Rect* rects, int count) override;
+    void drawRect(const SDL_Rect* rect) override;
+    void drawLine(int x1, int y1, int x2, int y2) override;
+    void drawPoint(int x, int y) override;
+    void copy(SDL_Texture* texture, const SDL_Rect* source, const SDL_Rect* dest) override;
+    void copyEx(SDL_Texture* texture, const SDL_Rect* source, const SDL_Rect* dest,
+                double angle, const SDL_Point* center, SDL_RendererFlip flip) override;
+    void geometry(SDL_Texture* texture, const SDL_Vertex* vertices, int vertexCount,
+                  const int* indices, int indexCount) override;
+
+    void present() override;
+
+    const RenderStats& getCurrentFrame() const { return current; }
+    const RenderStats& getLastFrame() const { return lastFrame; }
+    // 从创建起所有已提交帧的累计值和帧数
+    const RenderStats& getTotal() const { return total; }
+    int getFrameCount() const { return frameCount; }
+
+private:
+    std::unique_ptr<RenderBackend> inner;
+    RenderStats current;
+    RenderStats lastFrame;
+    RenderStats total;
+    int frameCount = 0;
+
+    // 跟踪当前状态以区分真正的切换和重复设置，初值取 SDL 渲染器的默认状态
+    SDL_Color drawColor = {0, 0, 0, 255};
+    SDL_BlendMode blendMode = SDL_BLENDMODE_NONE;
+    SDL_Rect clipRect = {0, 0, 0, 0};
+    bool clipEnabled = false;
+
+    void countState(bool changed);
+    // rect 为空表示整个渲染目标
+    long long areaOf(const SDL_Rect* rect) const;
+};
+
+#endif
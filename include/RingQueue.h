@@ -0,0 +1,38 @@
+#ifndef RING_QUEUE_H
+#define RING_QUEUE_H
+
+#include <memory>
+#include <cstddef>
+
+// 固定容量的环形队列：容量在 reset 时确定，之后入队出队都不再分配内存
+template <typename T>
+class RingQueue {
+public:
+    void reset(size_t capacity) {
+        size_t rounded = 1;
+        while (rounded < capacity) rounded <<= 1;
+        if (rounded != mask + 1 || !buffer) {
+            // 不做初始化：只有真正入队过的位置才会被访问
+            buffer.reset(new T[rounded]);
+        }
+        mask = rounded - 1;
+        head = tail = 0;
+    }
+    
+    void clear() { head = tail = 0; }
+    bool empty() const { return head == tail; }
+    size_t size() const { return tail - head; }
+    size_t capacity() const { return buffer ? mask + 1 : 0; }
+    
+    // 调用方保证 size() < capacity()
+    void push(const T& value) { buffer[tail++ & mask] = value; }
+    T pop() { return buffer[head++ & mask]; }
+
+private:
+    std::unique_ptr<T[]> buffer;
+    size_t mask = 0;
+    size_t head = 0;
+    size_t tail = 0;
+};
+
+#endif
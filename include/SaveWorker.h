@@ -0,0 +1,47 @@
+#ifndef SAVE_WORKER_H
+#define SAVE_WORKER_H
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// 后台存档线程：主线程只把要写的内容交过来，磁盘操作都在工作线程完成。
+// 同一文件短时间内的多次整体写入会合并成一次，只写最新的内容；
+// 整体写入先写临时文件并落盘（POSIX 用 fsync，Windows 用 _commit），再原子地替换目标文件，
+// 中途崩溃不会留下半个存档
+class SaveWorker {
+public:
+    SaveWorker();
+    ~SaveWorker();
+
+    void start();
+    // 写完所有未完成的请求再退出
+    void stop();
+
+    // 整体替换文件；尚未写出的旧内容直接被覆盖
+    void requestWrite(const std::string& path, std::string data);
+    // 追加到文件末尾，按提交顺序写出
+    void requestAppend(const std::string& path, std::string data);
+
+private:
+    void workerLoop();
+    static bool writeAtomically(const std::string& path, const std::string& data);
+    static bool appendDurably(const std::string& path, const std::string& data);
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool running;
+
+    std::map<std::string, std::string> pendingWrites;
+    std::vector<std::pair<std::string, std::string>> pendingAppends;
+
+    // 收到请求后等这么久再写，期间的新请求并入同一次写入
+    static constexpr int COALESCE_DELAY_MS = 200;
+};
+
+#endif
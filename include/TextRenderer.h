@@ -4,17 +4,57 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 #include <string>
+#include <map>
+#include <vector>
+#include "RenderBackend.h"
 
+// 字形图集文本渲染：每个字号第一次使用时把可打印 ASCII 字形光栅化进一张纹理，
+// 之后绘制字符串只是把一批四边形交给 SDL_RenderGeometry，不再逐帧创建纹理
 class TextRenderer {
 public:
     static bool init();
-    static void renderText(SDL_Renderer* renderer, const std::string& text, 
+    static void renderText(RenderBackend* renderer, const std::string& text,
                          int x, int y, SDL_Color color, int fontSize = 24);
+
+    // 字符串在给定字号下的像素宽度（含字距调整）
+    static int measureText(const std::string& text, int fontSize = 24);
+
+    // 渲染设备重置后图集纹理失效，下次绘制时重新生成
+    static void releaseTextures();
     static void cleanup();
 
 private:
-    static TTF_Font* font;
+    static constexpr int FIRST_GLYPH = 32;
+    static constexpr int LAST_GLYPH = 126;
+    static constexpr int GLYPH_COUNT = LAST_GLYPH - FIRST_GLYPH + 1;
+
+    struct Glyph {
+        SDL_Rect source;  // 在图集中的位置
+        int advance;
+    };
+
+    // 同一字体文件的一个字号
+    struct FontAtlas {
+        TTF_Font* font = nullptr;
+        SDL_Texture* texture = nullptr;
+        SDL_Renderer* owner = nullptr;
+        int textureWidth = 0;
+        int textureHeight = 0;
+        bool metricsReady = false;
+        Glyph glyphs[GLYPH_COUNT] = {};
+    };
+
+    static std::map<int, FontAtlas> atlases;
+    static std::string fontPath;
     static const char* FONT_PATH;
+
+    // 批量绘制用的顶点缓冲区，增长到最长字符串后不再分配
+    static std::vector<SDL_Vertex> vertices;
+    static std::vector<int> indices;
+
+    static FontAtlas* getAtlas(int fontSize);
+    static bool buildTexture(RenderBackend* renderer, FontAtlas& atlas);
+    static const Glyph* findGlyph(const FontAtlas& atlas, char c);
 };
 
-#endif 
\ No newline at end of file
+#endif
@@ -0,0 +1,45 @@
+#ifndef WALL_GEOMETRY_H
+#define WALL_GEOMETRY_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include <cstdint>
+#include "Maze.h"
+
+// 以格子为单位的矩形
+struct CellRect {
+    int x, y, w, h;
+};
+
+// 关卡加载时把相邻的墙格（和地面格）贪心合并成少量轴对齐矩形，
+// 渲染时每种颜色只需一次 SDL_RenderFillRects
+class WallGeometry {
+public:
+    void build(const Maze& maze);
+
+    const std::vector<CellRect>& getWallRects() const { return wallRects; }
+    const std::vector<CellRect>& getFloorRects() const { return floorRects; }
+
+    // 格子矩形转换为像素矩形
+    static void toPixels(const std::vector<CellRect>& cells, float offsetX, float offsetY,
+                         float cellSize, std::vector<SDL_Rect>& out);
+
+    // 沿墙块右侧和底部生成 2 像素宽的阴影条
+    static void buildShadows(const std::vector<SDL_Rect>& walls, std::vector<SDL_Rect>& out);
+
+private:
+    std::vector<CellRect> wallRects;
+    std::vector<CellRect> floorRects;
+
+    // 合并用的临时缓冲区，按关卡尺寸复用
+    std::vector<uint8_t> kinds;
+    std::vector<uint8_t> covered;
+    std::vector<CellRect> candidate;
+
+    // 先横向后纵向（或反之）贪心扩展，kind 相同且未覆盖的格子并入同一矩形
+    void mergeCells(int width, int height, uint8_t kind, bool rowsFirst,
+                    std::vector<CellRect>& out);
+    void mergeBest(int width, int height, uint8_t kind, std::vector<CellRect>& out);
+};
+
+#endif
@@ -0,0 +1,110 @@
+#include "AssetCache.h"
+#include <vector>
+
+SDL_Texture* AssetCache::background = nullptr;
+int AssetCache::backgroundHeight = 0;
+std::map<std::pair<int, int>, SDL_Texture*> AssetCache::panels;
+
+namespace {
+    // RGBA8888：0xRRGGBBAA
+    Uint32 packColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
+        return (static_cast<Uint32>(r) << 24) | (static_cast<Uint32>(g) << 16) |
+               (static_cast<Uint32>(b) << 8) | a;
+    }
+}
+
+SDL_Texture* AssetCache::createTexture(RenderBackend* renderer, int width, int height, const Uint32* pixels) {
+    SDL_Texture* texture = SDL_CreateTexture(renderer->getSDLRenderer(), SDL_PIXELFORMAT_RGBA8888,
+                                             SDL_TEXTUREACCESS_STATIC, width, height);
+    if (texture) {
+        SDL_UpdateTexture(texture, nullptr, pixels, width * static_cast<int>(sizeof(Uint32)));
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    }
+    return texture;
+}
+
+void AssetCache::renderBackground(RenderBackend* renderer, int width, int height) {
+    if (height <= 0) return;
+
+    // 渐变只沿竖直方向变化，烘焙成 1 像素宽的纹理再横向拉伸
+    if ((!background || backgroundHeight != height) && renderer->getSDLRenderer()) {
+        if (background) {
+            SDL_DestroyTexture(background);
+        }
+        std::vector<Uint32> pixels(height);
+        for (int y = 0; y < height; ++y) {
+            float factor = (float)y / height;
+            pixels[y] = packColor(static_cast<Uint8>(20 + factor * 20),
+                                  static_cast<Uint8>(20 + factor * 20),
+                                  static_cast<Uint8>(30 + factor * 30),
+                                  255);
+        }
+        background = createTexture(renderer, 1, height, pixels.data());
+        backgroundHeight = height;
+        if (background) {
+            SDL_SetTextureScaleMode(background, SDL_ScaleModeNearest);
+        }
+    }
+
+    if (background) {
+        SDL_Rect dest = {0, 0, width, height};
+        renderer->copy(background, nullptr, &dest);
+    } else {
+        // 纹理不可用时逐行绘制
+        for (int y = 0; y < height; ++y) {
+            float factor = (float)y / height;
+            renderer->setDrawColor(20 + factor * 20, 20 + factor * 20, 30 + factor * 30, 255);
+            renderer->drawLine(0, y, width, y);
+        }
+    }
+}
+
+void AssetCache::renderPanel(RenderBackend* renderer, const SDL_Rect& rect) {
+    if (rect.w <= 0 || rect.h <= 0) return;
+
+    SDL_Texture*& panel = panels[{rect.w, rect.h}];
+    if (!panel && renderer->getSDLRenderer()) {
+        // 半透明底色，一像素边框
+        const Uint32 fill = packColor(20, 20, 30, 200);
+        const Uint32 border = packColor(100, 100, 150, 255);
+        std::vector<Uint32> pixels(static_cast<size_t>(rect.w) * rect.h, fill);
+        for (int x = 0; x < rect.w; x++) {
+            pixels[x] = border;
+            pixels[static_cast<size_t>(rect.h - 1) * rect.w + x] = border;
+        }
+        for (int y = 0; y < rect.h; y++) {
+            pixels[static_cast<size_t>(y) * rect.w] = border;
+            pixels[static_cast<size_t>(y) * rect.w + rect.w - 1] = border;
+        }
+        panel = createTexture(renderer, rect.w, rect.h, pixels.data());
+    }
+
+    if (panel) {
+        renderer->copy(panel, nullptr, &rect);
+    } else {
+        panels.erase({rect.w, rect.h});
+        renderer->setDrawBlendMode(SDL_BLENDMODE_BLEND);
+        renderer->setDrawColor(20, 20, 30, 200);
+        renderer->fillRect(&rect);
+        renderer->setDrawColor(100, 100, 150, 255);
+        renderer->drawRect(&rect);
+    }
+}
+
+void AssetCache::invalidate() {
+    if (background) {
+        SDL_DestroyTexture(background);
+        background = nullptr;
+    }
+    backgroundHeight = 0;
+    for (auto& entry : panels) {
+        if (entry.second) {
+            SDL_DestroyTexture(entry.second);
+        }
+    }
+    panels.clear();
+}
+
+void AssetCache::cleanup() {
+    invalidate();
+}
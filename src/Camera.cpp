@@ -0,0 +1,89 @@
+#include "Camera.h"
+#include <algorithm>
+#include <cmath>
+
+void Camera::setViewport(const SDL_Rect& area) {
+    viewport = area;
+    zoom = std::min(zoom, maxZoom());
+}
+
+void Camera::setWorldSize(int width, int height) {
+    worldWidth = std::max(1, width);
+    worldHeight = std::max(1, height);
+    zoom = std::min(zoom, maxZoom());
+}
+
+void Camera::follow(float x, float y) {
+    targetX = x;
+    targetY = y;
+}
+
+void Camera::snapToTarget() {
+    centerX = previousX = targetX;
+    centerY = previousY = targetY;
+}
+
+void Camera::translate(float dx, float dy) {
+    centerX += dx;
+    centerY += dy;
+    previousX += dx;
+    previousY += dy;
+    targetX += dx;
+    targetY += dy;
+}
+
+void Camera::update(float deltaTime) {
+    // 指数平滑，与帧率无关
+    previousX = centerX;
+    previousY = centerY;
+    float t = 1.0f - std::exp(-FOLLOW_RATE * deltaTime);
+    centerX += (targetX - centerX) * t;
+    centerY += (targetY - centerY) * t;
+}
+
+void Camera::zoomBy(float factor) {
+    zoom = std::clamp(zoom * factor, 1.0f, maxZoom());
+}
+
+void Camera::resetZoom() {
+    float fit = fitCellSize();
+    zoom = fit < MIN_READABLE_CELL ? std::min(MIN_READABLE_CELL / fit, maxZoom()) : 1.0f;
+}
+
+float Camera::fitCellSize() const {
+    return std::min(static_cast<float>(viewport.w) / worldWidth,
+                    static_cast<float>(viewport.h) / worldHeight);
+}
+
+float Camera::maxZoom() const {
+    return std::max(1.0f, MAX_CELL_SIZE / fitCellSize());
+}
+
+float Camera::clampAxis(float center, int worldSize, int viewportSize) const {
+    float halfView = viewportSize / getCellSize() / 2;
+    if (halfView * 2 >= worldSize) {
+        return worldSize / 2.0f;
+    }
+    return std::clamp(center, halfView, worldSize - halfView);
+}
+
+float Camera::getOffsetX() const {
+    float x = clampAxis(previousX + (centerX - previousX) * renderAlpha, worldWidth, viewport.w);
+    return viewport.x + viewport.w / 2.0f - x * getCellSize();
+}
+
+float Camera::getOffsetY() const {
+    float y = clampAxis(previousY + (centerY - previousY) * renderAlpha, worldHeight, viewport.h);
+    return viewport.y + viewport.h / 2.0f - y * getCellSize();
+}
+
+void Camera::getVisibleCells(int& firstX, int& firstY, int& lastX, int& lastY) const {
+    float cellSize = getCellSize();
+    float offsetX = getOffsetX();
+    float offsetY = getOffsetY();
+
+    firstX = std::max(0, static_cast<int>(std::floor((viewport.x - offsetX) / cellSize)));
+    firstY = std::max(0, static_cast<int>(std::floor((viewport.y - offsetY) / cellSize)));
+    lastX = std::min(worldWidth, static_cast<int>(std::ceil((viewport.x + viewport.w - offsetX) / cellSize)));
+    lastY = std::min(worldHeight, static_cast<int>(std::ceil((viewport.y + viewport.h - offsetY) / cellSize)));
+}
@@ -1,113 +1,143 @@
 #include "Effects.h"
+#include "AssetCache.h"
+#include "ParticleSystem.h"
+#include "Profiler.h"
 #include <vector>
+#include <map>
+#include <algorithm>
 #include <cmath>
 
-struct Particle {
-    float x, y;
-    float vx, vy;
-    float life;
-    SDL_Color color;
-};
+// 背景漂浮粒子，整个程序共用一个固定容量的粒子池
+static ParticleSystem particles(Effects::MAX_PARTICLES);
+static int particleAreaWidth = 800;
+static int particleAreaHeight = 600;
+static float spawnTimer = 0.0f;
+static const float PARTICLE_SPAWN_INTERVAL = 1.0f / 6.0f;
 
-static std::vector<Particle> particles;
+void Effects::renderBlurPanel(RenderBackend* renderer, const SDL_Rect& rect) {
+    PROFILE_SCOPE("effects");
+    // 半透明背景和边框已按尺寸烘焙成纹理
+    AssetCache::renderPanel(renderer, rect);
+}
 
-void Effects::renderBlurPanel(SDL_Renderer* renderer, const SDL_Rect& rect) {
-    // 半透明背景
-    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-    SDL_SetRenderDrawColor(renderer, 20, 20, 30, 200);
-    SDL_RenderFillRect(renderer, &rect);
-    
-    // 边框
-    SDL_SetRenderDrawColor(renderer, 100, 100, 150, 255);
-    SDL_RenderDrawRect(renderer, &rect);
+void Effects::renderGlow(RenderBackend* renderer, const SDL_Rect& rect, SDL_Color color) {
+    PROFILE_SCOPE("effects");
+    renderer->setDrawBlendMode(SDL_BLENDMODE_BLEND);
+    renderer->setDrawColor(color.r, color.g, color.b, color.a);
+    renderer->fillRect(&rect);
 }
 
-void Effects::renderGlow(SDL_Renderer* renderer, const SDL_Rect& rect, SDL_Color color) {
-    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
-    SDL_RenderFillRect(renderer, &rect);
+void Effects::updateParticles(float deltaTime) {
+    // 按累计时间每秒生成 6 个，与调用频率无关；最多同时存在 AMBIENT_PARTICLES 个
+    spawnTimer += deltaTime;
+    while (spawnTimer >= PARTICLE_SPAWN_INTERVAL) {
+        spawnTimer -= PARTICLE_SPAWN_INTERVAL;
+        if (particles.size() >= AMBIENT_PARTICLES) continue;
+        particles.spawn(static_cast<float>(rand() % particleAreaWidth),
+                        static_cast<float>(rand() % particleAreaHeight),
+                        (rand() % 100 - 50) * 0.6f,   // 像素/秒
+                        (rand() % 100 - 50) * 0.6f,
+                        1.0f / 0.6f);                 // 约 1.7 秒淡出
+    }
+    particles.update(deltaTime);
 }
 
-void Effects::renderParticles(SDL_Renderer* renderer) {
-    static std::vector<Particle> particles;
+void Effects::renderParticles(RenderBackend* renderer) {
+    PROFILE_SCOPE("effects");
+    // 生成范围跟随实际输出尺寸
+    renderer->getOutputSize(&particleAreaWidth, &particleAreaHeight);
+    if (particleAreaWidth <= 0) particleAreaWidth = 1;
+    if (particleAreaHeight <= 0) particleAreaHeight = 1;
     
-    // 添加新粒子
-    if(particles.size() < 50 && rand() % 10 == 0) {
-        Particle p;
-        p.x = rand() % 800;
-        p.y = rand() % 600;
-        p.vx = (rand() % 100 - 50) / 100.0f;
-        p.vy = (rand() % 100 - 50) / 100.0f;
-        p.life = 1.0f;
-        p.color = {255, 255, 255, 100};
-        particles.push_back(p);
+    particles.render(renderer, {255, 255, 255, 100});
+}
+
+// 圆角纹理缓存：键为（半径, RGBA），值为左上角四分之一圆的抗锯齿纹理
+static std::map<std::pair<int, Uint32>, SDL_Texture*> cornerTextures;
+static const size_t MAX_CORNER_TEXTURES = 64;
+
+static SDL_Texture* getCornerTexture(RenderBackend* renderer, int radius, SDL_Color color) {
+    Uint32 key = (static_cast<Uint32>(color.r) << 24) | (static_cast<Uint32>(color.g) << 16) |
+                 (static_cast<Uint32>(color.b) << 8) | color.a;
+    auto it = cornerTextures.find({radius, key});
+    if (it != cornerTextures.end()) return it->second;
+    if (!renderer->getSDLRenderer()) return nullptr;
+    
+    // 缩放时半径会变化，缓存过多时整体清空
+    if (cornerTextures.size() >= MAX_CORNER_TEXTURES) {
+        Effects::cleanup();
     }
     
-    // 更新和渲染粒子
-    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-    for(auto it = particles.begin(); it != particles.end();) {
-        it->x += it->vx;
-        it->y += it->vy;
-        it->life -= 0.01f;
-        
-        if(it->life <= 0) {
-            it = particles.erase(it);
-            continue;
+    // 圆心在纹理右下角，每个像素 4x4 超采样得到覆盖率
+    const int SAMPLES = 4;
+    std::vector<Uint32> pixels(static_cast<size_t>(radius) * radius);
+    for (int y = 0; y < radius; y++) {
+        for (int x = 0; x < radius; x++) {
+            int covered = 0;
+            for (int sy = 0; sy < SAMPLES; sy++) {
+                for (int sx = 0; sx < SAMPLES; sx++) {
+                    float dx = radius - (x + (sx + 0.5f) / SAMPLES);
+                    float dy = radius - (y + (sy + 0.5f) / SAMPLES);
+                    if (dx * dx + dy * dy <= static_cast<float>(radius * radius)) covered++;
+                }
+            }
+            Uint32 alpha = color.a * covered / (SAMPLES * SAMPLES);
+            pixels[static_cast<size_t>(y) * radius + x] = (key & 0xFFFFFF00) | alpha;
         }
-        
-        SDL_SetRenderDrawColor(renderer, 
-                             it->color.r, 
-                             it->color.g, 
-                             it->color.b, 
-                             (Uint8)(it->color.a * it->life));
-        SDL_RenderDrawPoint(renderer, (int)it->x, (int)it->y);
-        ++it;
     }
+    
+    SDL_Texture* texture = SDL_CreateTexture(renderer->getSDLRenderer(), SDL_PIXELFORMAT_RGBA8888,
+                                             SDL_TEXTUREACCESS_STATIC, radius, radius);
+    if (texture) {
+        SDL_UpdateTexture(texture, nullptr, pixels.data(), radius * static_cast<int>(sizeof(Uint32)));
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+        cornerTextures[{radius, key}] = texture;
+    }
+    return texture;
 }
 
-void Effects::renderRoundedRect(SDL_Renderer* renderer, const SDL_Rect& rect, int radius) {
-    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+void Effects::renderRoundedRect(RenderBackend* renderer, const SDL_Rect& rect, int radius, SDL_Color color) {
+    PROFILE_SCOPE("effects");
+    renderer->setDrawBlendMode(SDL_BLENDMODE_BLEND);
+    renderer->setDrawColor(color.r, color.g, color.b, color.a);
+    
+    radius = std::min(radius, std::min(rect.w, rect.h) / 2);
+    SDL_Texture* corner = radius > 0 ? getCornerTexture(renderer, radius, color) : nullptr;
+    if (!corner) {
+        renderer->fillRect(&rect);
+        return;
+    }
     
-    // 填充主体
-    SDL_SetRenderDrawColor(renderer, 40, 40, 60, 255);
-    SDL_Rect innerRect = {
-        rect.x + radius,
-        rect.y + radius,
-        rect.w - 2 * radius,
-        rect.h - 2 * radius
+    // 九宫格：中间一列通高，左右两条去掉圆角部分，一次提交
+    SDL_Rect body[3] = {
+        {rect.x + radius, rect.y, rect.w - 2 * radius, rect.h},
+        {rect.x, rect.y + radius, radius, rect.h - 2 * radius},
+        {rect.x + rect.w - radius, rect.y + radius, radius, rect.h - 2 * radius}
     };
-    SDL_RenderFillRect(renderer, &innerRect);
+    renderer->fillRects(body, 3);
     
-    // 绘制圆角
-    for(int w = 0; w < radius * 2; w++) {
-        for(int h = 0; h < radius * 2; h++) {
-            float distance = sqrt((radius - w) * (radius - w) + 
-                                (radius - h) * (radius - h));
-            
-            if(distance <= radius) {
-                // 左上角
-                SDL_RenderDrawPoint(renderer, 
-                                  rect.x + w, 
-                                  rect.y + h);
-                // 右上角
-                SDL_RenderDrawPoint(renderer, 
-                                  rect.x + rect.w - w - 1, 
-                                  rect.y + h);
-                // 左下角
-                SDL_RenderDrawPoint(renderer, 
-                                  rect.x + w, 
-                                  rect.y + rect.h - h - 1);
-                // 右下角
-                SDL_RenderDrawPoint(renderer, 
-                                  rect.x + rect.w - w - 1, 
-                                  rect.y + rect.h - h - 1);
-            }
-        }
+    // 四个角共用一张纹理，通过翻转得到其余三个方向
+    SDL_Rect topLeft = {rect.x, rect.y, radius, radius};
+    SDL_Rect topRight = {rect.x + rect.w - radius, rect.y, radius, radius};
+    SDL_Rect bottomLeft = {rect.x, rect.y + rect.h - radius, radius, radius};
+    SDL_Rect bottomRight = {rect.x + rect.w - radius, rect.y + rect.h - radius, radius, radius};
+    renderer->copy(corner, nullptr, &topLeft);
+    renderer->copyEx(corner, nullptr, &topRight, 0.0, nullptr, SDL_FLIP_HORIZONTAL);
+    renderer->copyEx(corner, nullptr, &bottomLeft, 0.0, nullptr, SDL_FLIP_VERTICAL);
+    renderer->copyEx(corner, nullptr, &bottomRight, 0.0, nullptr,
+                     static_cast<SDL_RendererFlip>(SDL_FLIP_HORIZONTAL | SDL_FLIP_VERTICAL));
+}
+
+void Effects::cleanup() {
+    for (auto& entry : cornerTextures) {
+        SDL_DestroyTexture(entry.second);
     }
+    cornerTextures.clear();
 }
 
-void Effects::renderWallShadow(SDL_Renderer* renderer, const SDL_Rect& rect) {
-    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+void Effects::renderWallShadow(RenderBackend* renderer, const SDL_Rect& rect) {
+    PROFILE_SCOPE("effects");
+    renderer->setDrawBlendMode(SDL_BLENDMODE_BLEND);
     
     // 右侧阴影
     SDL_Rect shadowRight = {
@@ -116,8 +146,8 @@ void Effects::renderWallShadow(SDL_Renderer* renderer, const SDL_Rect& rect) {
         2,
         rect.h - 2
     };
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 100);
-    SDL_RenderFillRect(renderer, &shadowRight);
+    renderer->setDrawColor(0, 0, 0, 100);
+    renderer->fillRect(&shadowRight);
     
     // 底部阴影
     SDL_Rect shadowBottom = {
@@ -126,13 +156,14 @@ void Effects::renderWallShadow(SDL_Renderer* renderer, const SDL_Rect& rect) {
         rect.w - 2,
         2
     };
-    SDL_RenderFillRect(renderer, &shadowBottom);
+    renderer->fillRect(&shadowBottom);
 }
 
-void Effects::renderProgressBar(SDL_Renderer* renderer, const SDL_Rect& rect, float progress) {
+void Effects::renderProgressBar(RenderBackend* renderer, const SDL_Rect& rect, float progress) {
+    PROFILE_SCOPE("effects");
     // 背景
-    SDL_SetRenderDrawColor(renderer, 40, 40, 60, 255);
-    SDL_RenderFillRect(renderer, &rect);
+    renderer->setDrawColor(40, 40, 60, 255);
+    renderer->fillRect(&rect);
     
     // 进度条
     SDL_Rect progressRect = {
@@ -141,10 +172,10 @@ void Effects::renderProgressBar(SDL_Renderer* renderer, const SDL_Rect& rect, fl
         static_cast<int>(rect.w * progress),
         rect.h
     };
-    SDL_SetRenderDrawColor(renderer, 100, 200, 255, 255);
-    SDL_RenderFillRect(renderer, &progressRect);
+    renderer->setDrawColor(100, 200, 255, 255);
+    renderer->fillRect(&progressRect);
     
     // 边框
-    SDL_SetRenderDrawColor(renderer, 100, 100, 150, 255);
-    SDL_RenderDrawRect(renderer, &rect);
+    renderer->setDrawColor(100, 100, 150, 255);
+    renderer->drawRect(&rect);
 } 
\ No newline at end of file
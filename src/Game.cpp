@@ -5,29 +5,77 @@
 // #include <ctime>
 #include <iostream>
 #include "Effects.h"
+#include "AssetCache.h"
+#include "Profiler.h"
 // #include "TextRenderer.h"
-#include <queue>
-#include <map>
 #include <algorithm>
 #include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <sstream>
 
 Game::Game() : 
+    WINDOW_WIDTH(800),
+    WINDOW_HEIGHT(600),
     window(nullptr), 
     renderer(nullptr), 
+    backend(nullptr),
+    drawCounter(nullptr),
+    backendType(RenderBackendType::SDL),
+    headless(false),
+    headlessFrames(0),
+    headlessSurface(nullptr),
+    startLevel(0),
+    inputRecorder(nullptr),
+    recordingInput(false),
+    replayingInput(false),
+    fastReplay(false),
+    simulationStep(0),
+    persistProgress(false),
+    mouseX(-1),
+    mouseY(-1),
+    mouseLeftDown(false),
+    mazeLayerTexture(nullptr),
+    mazeLayerDirty(true),
+    frameTexture(nullptr),
+    snapshotTexture(nullptr),
+    frameTextureWidth(0),
+    frameTextureHeight(0),
+    transitionActive(false),
+    transitionTime(0.0),
+    needsRedraw(true),
+    lowPowerMode(false),
+    miniMapTexture(nullptr),
+    miniMapDirty(true),
     currentState(GameState::MENU),
     currentMaze(nullptr),  // 先设为 nullptr
     player(nullptr),      // 先设为 nullptr
+    endlessStream(nullptr),
+    pregenerator(nullptr),
+    saveWorker(nullptr),
     maxUnlockedLevel(1),
     currentLevel(1),
+    maxRandomLevel(0),
+    randomMode(false),
+    randomLevel(1),
     isRunning(false),
+    endlessMode(false),
+    endlessDepth(0),
     moveCount(0),
-    gameTime(0.0f),
+    gameTime(0.0),
+    ghostX(1),
+    ghostY(1),
+    ghostStep(0),
+    accumulator(0.0),
+    framePacing(FramePacing::VSYNC),
+    targetFps(60),
+    frameTimes{},
+    frameTimeIndex(0),
+    frameTimeCount(0),
+    optimalMoves(-1),
     showHint(false)
 {
     try {
-        // 加载游戏进度
-        loadGameProgress();
-        
         // 初始化迷宫和玩家
         currentMaze = new Maze();
         if (!currentMaze) {
@@ -84,9 +132,6 @@ Game::Game() :
 }
 
 void Game::calculateMazeRenderArea() {
-    // 假设窗口大小为 800x600
-    const int WINDOW_WIDTH = 800;
-    const int WINDOW_HEIGHT = 600;
     const int LEFT_PANEL_WIDTH = 160; // 左侧面板宽度
 
     // 计算迷宫区域（右侧区域）
@@ -94,6 +139,8 @@ void Game::calculateMazeRenderArea() {
     mazeRenderArea.y = 20; // 顶部间距
     mazeRenderArea.w = WINDOW_WIDTH - LEFT_PANEL_WIDTH - 40; // 减去左侧面板和间距
     mazeRenderArea.h = WINDOW_HEIGHT - 40; // 减去上下间距
+    
+    camera.setViewport(mazeRenderArea);
 }
 
 Game::~Game() {
@@ -101,7 +148,33 @@ Game::~Game() {
 }
 
 bool Game::init() {
-    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER) < 0) {
+    if (!headless && !replayingInput) {
+        // 存档在后台线程写出，主循环不等待磁盘
+        persistProgress = true;
+        saveWorker = new SaveWorker();
+        saveWorker->start();
+        
+        // 加载游戏进度
+        loadGameProgress();
+    }
+    
+    if (replayingInput) {
+        inputRecorder = new InputRecorder();
+        if (!inputRecorder->load(inputPath)) {
+            return false;
+        }
+        maxUnlockedLevel = inputRecorder->getStartUnlockedLevel();
+        if (fastReplay) {
+            framePacing = FramePacing::UNCAPPED;
+        }
+    } else if (recordingInput) {
+        inputRecorder = new InputRecorder();
+        inputRecorder->setStartUnlockedLevel(maxUnlockedLevel);
+    }
+    
+    // 无窗口模式不需要视频子系统
+    Uint32 subsystems = headless ? (SDL_INIT_TIMER | SDL_INIT_EVENTS) : (SDL_INIT_VIDEO | SDL_INIT_TIMER);
+    if (SDL_Init(subsystems) < 0) {
         return false;
     }
 
@@ -109,22 +182,53 @@ bool Game::init() {
     WINDOW_WIDTH = 800;
     WINDOW_HEIGHT = 600;
 
-    window = SDL_CreateWindow("Maze Runner", 
-                            SDL_WINDOWPOS_CENTERED, 
-                            SDL_WINDOWPOS_CENTERED,
-                            WINDOW_WIDTH, 
-                            WINDOW_HEIGHT, 
-                            SDL_WINDOW_SHOWN);
-    
-    if (!window) {
-        return false;
-    }
+    if (headless) {
+        // 软件渲染到内存表面，没有 VSync，帧率不受限制
+        headlessSurface = SDL_CreateRGBSurfaceWithFormat(0, WINDOW_WIDTH, WINDOW_HEIGHT, 32,
+                                                         SDL_PIXELFORMAT_ARGB8888);
+        if (!headlessSurface) {
+            return false;
+        }
+        renderer = SDL_CreateSoftwareRenderer(headlessSurface);
+        if (!renderer) {
+            return false;
+        }
+        framePacing = FramePacing::UNCAPPED;
+    } else {
+        window = SDL_CreateWindow("Maze Runner", 
+                                SDL_WINDOWPOS_CENTERED, 
+                                SDL_WINDOWPOS_CENTERED,
+                                WINDOW_WIDTH, 
+                                WINDOW_HEIGHT, 
+                                SDL_WINDOW_SHOWN);
+        
+        if (!window) {
+            return false;
+        }
 
-    renderer = SDL_CreateRenderer(window, -1, 
-                                SDL_RENDERER_ACCELERATED | 
-                                SDL_RENDERER_PRESENTVSYNC);
-    if (!renderer) {
-        return false;
+        Uint32 rendererFlags = SDL_RENDERER_ACCELERATED;
+        if (framePacing == FramePacing::VSYNC) {
+            rendererFlags |= SDL_RENDERER_PRESENTVSYNC;
+        }
+        renderer = SDL_CreateRenderer(window, -1, rendererFlags);
+        if (!renderer) {
+            return false;
+        }
+    }
+    
+    switch (backendType) {
+        case RenderBackendType::COUNTING:
+            drawCounter = new CountingRenderBackend(std::make_unique<SDLRenderBackend>(renderer));
+            backend = drawCounter;
+            break;
+        case RenderBackendType::NULL_OUTPUT:
+            drawCounter = new CountingRenderBackend(
+                std::make_unique<NullRenderBackend>(renderer, WINDOW_WIDTH, WINDOW_HEIGHT));
+            backend = drawCounter;
+            break;
+        default:
+            backend = new SDLRenderBackend(renderer);
+            break;
     }
 
     // 初始化 TTF
@@ -137,71 +241,338 @@ bool Game::init() {
         return false;
     }
 
+    // 启动随机挑战的后台预生成线程
+    pregenerator = new MazePregenerator();
+    pregenerator->setUpcomingSizes({randomLevelSize(1), randomLevelSize(2)});
+    pregenerator->start();
+
+    // 无窗口和回放时背景粒子也要每次相同
+    if (headless || replayingInput) {
+        srand(DETERMINISTIC_SEED);
+    }
+    
+    if (startLevel > 0 && loadLevel(startLevel)) {
+        transitionToState(GameState::PLAYING);
+    }
+
     return true;
 }
 
 void Game::run() {
     isRunning = true;
-    Uint32 lastTime = SDL_GetTicks();
-    const int FPS = 60;
-    const int frameDelay = 1000 / FPS;
+    
+    // 高精度计时：逻辑按固定步长推进，与渲染帧率无关
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+    Uint64 previousCounter = SDL_GetPerformanceCounter();
+    const Uint64 runStart = previousCounter;
+    accumulator = 0.0;
+    int renderedFrames = 0;
 
     while (isRunning) {
-        Uint32 frameStart = SDL_GetTicks();
+        // 无窗口模式每帧都渲染
+        if (headless) {
+            needsRedraw = true;
+        }
+        
+        // 静止界面没有动画时阻塞等待事件，几乎不占 CPU
+        if (!needsRedraw && !isAnimating()) {
+            SDL_Event event;
+            if (SDL_WaitEventTimeout(&event, IDLE_WAIT_MS)) {
+                dispatchEvent(event);
+            }
+            // 等待的时间不计入模拟
+            previousCounter = SDL_GetPerformanceCounter();
+            if (!needsRedraw) continue;
+        }
+        
+        Uint64 frameStart = SDL_GetPerformanceCounter();
+        double frameTime = static_cast<double>(frameStart - previousCounter) / frequency;
+        previousCounter = frameStart;
+        recordFrameTime(frameTime);
+        
+        // 无窗口模式和快速回放按模拟时钟推进，输出与机器快慢无关
+        if (headless || fastReplay) {
+            frameTime = SIMULATED_FRAME_TIME;
+        }
+        
+        // 拖动窗口等长时间卡顿后不一次追赶过多步数
+        accumulator += std::min(frameTime, MAX_FRAME_TIME);
         
         // 处理事件
+        // 回放时忽略实际输入，只响应关闭窗口
         SDL_Event event;
         while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_QUIT) {
-                isRunning = false;
+            if (!replayingInput || event.type == SDL_QUIT || event.type == SDL_WINDOWEVENT) {
+                dispatchEvent(event);
             }
-            switch (currentState) {
-                case GameState::MENU:
-                    handleMenuMouseEvents(event);
-                    break;
-                case GameState::LEVEL_SELECT:
-                    handleLevelSelectMouseEvents(event);
-                    break;
-                case GameState::PLAYING:
-                    handlePlayingEvents(event);
-                    break;
-                case GameState::LEVEL_COMPLETE:
-                    handleLevelCompleteMouseEvents(event);
-                    break;
-                default:
-                    break;
+        }
+
+        // 更新游戏状态；回放的事件按录制时的步数插在两次更新之间
+        feedReplayEvents();
+        while (accumulator >= FIXED_TIMESTEP) {
+            update(FIXED_TIMESTEP);
+            accumulator -= FIXED_TIMESTEP;
+            simulationStep++;
+            feedReplayEvents();
+        }
+        
+        if (replayingInput && inputRecorder->finished()) {
+            isRunning = false;
+        }
+        
+        // 剩余不足一步的时间用于渲染插值
+        camera.setRenderAlpha(static_cast<float>(accumulator / FIXED_TIMESTEP));
+
+        // 只有画面失效或仍有动画时才重新渲染和提交
+        if (needsRedraw || isAnimating()) {
+            // 渲染当前状态（含状态切换的淡出）
+            renderFrame();
+
+            // 性能叠加层画在过渡之上，不进入帧纹理
+            Profiler::renderOverlay(backend);
+            
+            // 显示渲染结果
+            backend->present();
+            Profiler::endFrame();
+            needsRedraw = false;
+            renderedFrames++;
+            
+            if (headless) {
+                if (std::find(frameDumps.begin(), frameDumps.end(), renderedFrames) != frameDumps.end()) {
+                    dumpFrame(renderedFrames);
+                }
+                if (renderedFrames >= headlessFrames) {
+                    isRunning = false;
+                }
             }
         }
 
-        // 更新游戏状态
-        update();
+        // 帧率控制：VSync 由 Present 阻塞，不再额外睡眠
+        if (framePacing == FramePacing::CAPPED) {
+            waitForNextFrame(frameStart, frequency);
+        }
+    }
+    
+    if (headless || replayingInput) {
+        double seconds = static_cast<double>(SDL_GetPerformanceCounter() - runStart) / frequency;
+        std::cout << (replayingInput ? "Replay: " : "Headless: ")
+                  << simulationStep << " steps, "
+                  << renderedFrames << " frames in " << seconds * 1000.0 << " ms, "
+                  << (renderedFrames > 0 ? seconds * 1000.0 / renderedFrames : 0.0)
+                  << " ms per frame" << std::endl;
+    }
+}
 
-        // 清除屏幕
-        SDL_SetRenderDrawColor(renderer, 20, 20, 30, 255);
-        SDL_RenderClear(renderer);
+void Game::feedReplayEvents() {
+    if (!replayingInput) return;
+    
+    SDL_Event event;
+    while (inputRecorder->nextEvent(simulationStep, event)) {
+        dispatchEvent(event);
+    }
+}
 
-        // 渲染当前状态
-        render();
+bool Game::takeReplaySeed(uint32_t& seed) {
+    if (!replayingInput) return false;
+    if (!inputRecorder->nextSeed(seed)) {
+        std::cerr << "Input recording has no seed left, maze will differ" << std::endl;
+        return false;
+    }
+    return true;
+}
 
-        // 显示渲染结果
-        SDL_RenderPresent(renderer);
+void Game::recordSeed(uint32_t seed) {
+    if (recordingInput) {
+        inputRecorder->recordSeed(simulationStep, seed);
+    }
+}
 
-        // 帧率控制
-        int frameTime = SDL_GetTicks() - frameStart;
-        if (frameDelay > frameTime) {
-            SDL_Delay(frameDelay - frameTime);
-        }
+void Game::dumpFrame(int frame) {
+    char filename[32];
+    snprintf(filename, sizeof(filename), "frame_%05d.bmp", frame);
+    if (SDL_SaveBMP(headlessSurface, filename) != 0) {
+        std::cerr << "Failed to save " << filename << ": " << SDL_GetError() << std::endl;
     }
 }
 
-void Game::update() {
+void Game::dispatchEvent(const SDL_Event& event) {
+    // 任何输入或窗口事件都可能改变画面（悬停、按下、重绘请求）
+    needsRedraw = true;
+    
+    if (recordingInput && InputRecorder::isRecordable(event)) {
+        inputRecorder->recordEvent(simulationStep, event);
+    }
+    
+    switch (event.type) {
+        case SDL_MOUSEMOTION:
+            mouseX = event.motion.x;
+            mouseY = event.motion.y;
+            break;
+        case SDL_MOUSEBUTTONDOWN:
+        case SDL_MOUSEBUTTONUP:
+            mouseX = event.button.x;
+            mouseY = event.button.y;
+            if (event.button.button == SDL_BUTTON_LEFT) {
+                mouseLeftDown = event.type == SDL_MOUSEBUTTONDOWN;
+            }
+            break;
+        default:
+            break;
+    }
+    
+    if (event.type == SDL_QUIT) {
+        isRunning = false;
+    }
+    if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F3) {
+        Profiler::toggleOverlay();
+    }
+    handleWindowEvent(event);
+    switch (currentState) {
+        case GameState::MENU:
+            handleMenuMouseEvents(event);
+            handleMenuEvents(event);
+            break;
+        case GameState::LEVEL_SELECT:
+            handleLevelSelectMouseEvents(event);
+            break;
+        case GameState::PLAYING:
+            handlePlayingEvents(event);
+            break;
+        case GameState::LEVEL_COMPLETE:
+            handleLevelCompleteMouseEvents(event);
+            break;
+        default:
+            break;
+    }
+}
+
+bool Game::isAnimating() const {
+    // 游戏中计时和镜头一直在变；其他界面只有粒子和过渡在动
+    return transitionActive ||
+           currentState == GameState::PLAYING ||
+           replayingInput ||
+           !lowPowerMode;
+}
+
+void Game::setLowPowerMode(bool enabled) {
+    lowPowerMode = enabled;
+    needsRedraw = true;
+}
+
+void Game::waitForNextFrame(Uint64 frameStart, Uint64 frequency) {
+    const Uint64 frameTicks = frequency / static_cast<Uint64>(std::max(1, targetFps));
+    const Uint64 deadline = frameStart + frameTicks;
+    const Uint64 oneMs = frequency / 1000;
+    
+    // 先粗略睡眠，最后一毫秒自旋等待，避免 SDL_Delay 的粒度误差
+    Uint64 now = SDL_GetPerformanceCounter();
+    while (now + oneMs < deadline) {
+        SDL_Delay(static_cast<Uint32>((deadline - now - oneMs) * 1000 / frequency));
+        now = SDL_GetPerformanceCounter();
+    }
+    while (now < deadline) {
+        now = SDL_GetPerformanceCounter();
+    }
+}
+
+void Game::setFramePacing(FramePacing pacing, int fps) {
+    framePacing = pacing;
+    targetFps = std::max(1, fps);
+}
+
+void Game::setRenderBackend(RenderBackendType type) {
+    backendType = type;
+}
+
+void Game::setHeadless(int frames) {
+    headless = true;
+    headlessFrames = std::max(1, frames);
+}
+
+void Game::addFrameDump(int frame) {
+    frameDumps.push_back(frame);
+}
+
+void Game::setStartLevel(int level) {
+    startLevel = level;
+}
+
+void Game::recordInput(const std::string& path) {
+    recordingInput = true;
+    replayingInput = false;
+    inputPath = path;
+}
+
+void Game::replayInput(const std::string& path, bool fast) {
+    replayingInput = true;
+    recordingInput = false;
+    fastReplay = fast;
+    inputPath = path;
+}
+
+void Game::printRenderStats() const {
+    if (!drawCounter || drawCounter->getFrameCount() == 0) return;
+    
+    const RenderStats& total = drawCounter->getTotal();
+    double frames = drawCounter->getFrameCount();
+    std::cout << "Render stats over " << drawCounter->getFrameCount() << " frames: "
+              << total.drawCalls / frames << " draw calls, "
+              << total.stateChanges / frames << " state changes ("
+              << total.redundantStates / frames << " redundant), "
+              << total.pixelsFilled / frames / 1000000.0 << " Mpx filled per frame, "
+              << getAverageFrameTimeMs() << " ms average frame" << std::endl;
+}
+
+void Game::recordFrameTime(double seconds) {
+    frameTimes[frameTimeIndex] = seconds;
+    frameTimeIndex = (frameTimeIndex + 1) % FRAME_HISTORY;
+    frameTimeCount = std::min(frameTimeCount + 1, FRAME_HISTORY);
+}
+
+double Game::getAverageFrameTimeMs() const {
+    if (frameTimeCount == 0) return 0.0;
+    double sum = 0.0;
+    for (int i = 0; i < frameTimeCount; i++) {
+        sum += frameTimes[i];
+    }
+    return sum / frameTimeCount * 1000.0;
+}
+
+double Game::getFrameJitterMs() const {
+    if (frameTimeCount < 2) return 0.0;
+    double mean = getAverageFrameTimeMs() / 1000.0;
+    double variance = 0.0;
+    for (int i = 0; i < frameTimeCount; i++) {
+        double diff = frameTimes[i] - mean;
+        variance += diff * diff;
+    }
+    return std::sqrt(variance / (frameTimeCount - 1)) * 1000.0;
+}
+
+void Game::update(double deltaTime) {
+    PROFILE_SCOPE("update");
+    // 背景粒子在所有界面都会显示，低功耗模式下暂停
+    if (!lowPowerMode) {
+        Effects::updateParticles(static_cast<float>(deltaTime));
+    }
+    
+    if (transitionActive) {
+        transitionTime += deltaTime;
+        if (transitionTime >= TRANSITION_DURATION) {
+            transitionActive = false;
+            // 过渡结束后 isAnimating() 变为 false，补画一帧去掉残留的快照
+            needsRedraw = true;
+        }
+    }
+    
     if (currentState == GameState::PLAYING) {
-        static Uint32 lastTime = SDL_GetTicks();
-        Uint32 currentTime = SDL_GetTicks();
-        float deltaTime = (currentTime - lastTime) / 1000.0f;
-        lastTime = currentTime;
-        
         gameTime += deltaTime;
+        updateGhost();
+        
+        if (player) {
+            camera.follow(player->getX() + 0.5f, player->getY() + 0.5f);
+            camera.update(static_cast<float>(deltaTime));
+        }
     }
 }
 
@@ -230,17 +601,66 @@ void Game::render() {
 
 void Game::cleanup() {
     saveGameProgress();
+    // 停止前写完所有未完成的存档请求
+    if (saveWorker) {
+        delete saveWorker;
+        saveWorker = nullptr;
+    }
+    persistProgress = false;
+    Profiler::writeTrace("profile_trace.json");
+    
+    // 先停掉工作线程再释放其他资源
+    if (pregenerator) {
+        delete pregenerator;
+        pregenerator = nullptr;
+    }
     
     if (player) {
         delete player;
         player = nullptr;
     }
     
+    if (endlessStream) {
+        delete endlessStream;
+        endlessStream = nullptr;
+    }
+    
     if (currentMaze) {
         delete currentMaze;
         currentMaze = nullptr;
     }
     
+    if (mazeLayerTexture) {
+        SDL_DestroyTexture(mazeLayerTexture);
+        mazeLayerTexture = nullptr;
+    }
+    
+    if (miniMapTexture) {
+        SDL_DestroyTexture(miniMapTexture);
+        miniMapTexture = nullptr;
+    }
+    
+    releaseFrameTextures();
+    
+    if (inputRecorder) {
+        if (recordingInput && inputRecorder->save(inputPath)) {
+            std::cout << "Recorded " << inputRecorder->getEventCount() << " events and "
+                      << inputRecorder->getSeedCount() << " seeds to " << inputPath << std::endl;
+        }
+        delete inputRecorder;
+        inputRecorder = nullptr;
+    }
+    
+    printRenderStats();
+    delete backend;
+    backend = nullptr;
+    drawCounter = nullptr;
+    
+    // 字形图集和烘焙的界面纹理要在渲染器销毁前释放
+    TextRenderer::cleanup();
+    AssetCache::cleanup();
+    Effects::cleanup();
+    
     if (renderer) {
         SDL_DestroyRenderer(renderer);
         renderer = nullptr;
@@ -251,20 +671,60 @@ void Game::cleanup() {
         window = nullptr;
     }
     
+    // 软件渲染器画在这个表面上，要等渲染器销毁后再释放
+    if (headlessSurface) {
+        SDL_FreeSurface(headlessSurface);
+        headlessSurface = nullptr;
+    }
+    
     SDL_Quit();
-    TextRenderer::cleanup();
+}
+
+void Game::handleWindowEvent(const SDL_Event& event) {
+    if (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED) {
+        WINDOW_WIDTH = event.window.data1;
+        WINDOW_HEIGHT = event.window.data2;
+        calculateMazeRenderArea();
+        invalidateMazeLayer();
+        AssetCache::invalidate();
+        // 帧纹理在下一帧按新尺寸重建，进行中的过渡直接结束
+        releaseFrameTextures();
+    } else if (event.type == SDL_RENDER_TARGETS_RESET || event.type == SDL_RENDER_DEVICE_RESET) {
+        // 渲染目标纹理的内容已丢失
+        invalidateMazeLayer();
+        if (event.type == SDL_RENDER_DEVICE_RESET) {
+            // 设备重置后所有纹理都失效，需要重新创建
+            if (mazeLayerTexture) {
+                SDL_DestroyTexture(mazeLayerTexture);
+                mazeLayerTexture = nullptr;
+            }
+            if (miniMapTexture) {
+                SDL_DestroyTexture(miniMapTexture);
+                miniMapTexture = nullptr;
+            }
+            miniMapDirty = true;
+            releaseFrameTextures();
+            AssetCache::invalidate();
+            Effects::cleanup();
+            TextRenderer::releaseTextures();
+        }
+    }
 }
 
 void Game::handleMenuEvents(const SDL_Event& event) {
     if (event.type == SDL_KEYDOWN) {
         switch (event.key.keysym.sym) {
             case SDLK_1:
-                currentState = GameState::LEVEL_SELECT;
+                transitionToState(GameState::LEVEL_SELECT);
                 break;
             case SDLK_2:
-                currentState = GameState::RANDOM_CHALLENGE;
+                randomLevel = 1;
                 generateRandomLevel();
-                currentState = GameState::PLAYING;
+                transitionToState(GameState::PLAYING);
+                break;
+            case SDLK_3:
+                startEndlessMode();
+                transitionToState(GameState::PLAYING);
                 break;
             case SDLK_ESCAPE:
                 isRunning = false;
@@ -279,30 +739,43 @@ void Game::handleLevelSelectEvents(const SDL_Event& event) {
             int level = event.key.keysym.sym - SDLK_0;
             if (level <= currentLevel) {
                 loadLevel(level);
-                currentState = GameState::PLAYING;
+                transitionToState(GameState::PLAYING);
             }
         } else if (event.key.keysym.sym == SDLK_ESCAPE) {
-            currentState = GameState::MENU;
+            transitionToState(GameState::MENU);
         }
     }
 }
 
 void Game::handlePlayingEvents(const SDL_Event& event) {
+    PROFILE_SCOPE("events");
+    if (event.type == SDL_MOUSEWHEEL) {
+        // 滚轮缩放，每格 1.25 倍
+        if (event.wheel.y > 0) {
+            camera.zoomBy(1.25f);
+        } else if (event.wheel.y < 0) {
+            camera.zoomBy(0.8f);
+        }
+        return;
+    }
     if (event.type == SDL_MOUSEBUTTONDOWN) {
-        int x, y;
-        SDL_GetMouseState(&x, &y);
-        
         // 检查返回按钮
         if (isMouseOver(backButton)) {
-            currentState = GameState::LEVEL_SELECT;
+            transitionToState(GameState::LEVEL_SELECT);
             return;
         }
         
         // 检查重试按钮
         if (isMouseOver(retryButton)) {
             moveCount = 0;
-            gameTime = 0.0f;
-            loadLevel(currentLevel);
+            gameTime = 0.0;
+            if (endlessMode) {
+                startEndlessMode();
+            } else if (randomMode) {
+                generateRandomLevel();
+            } else {
+                loadLevel(currentLevel);
+            }
             return;
         }
         
@@ -317,30 +790,50 @@ void Game::handlePlayingEvents(const SDL_Event& event) {
         }
     }
     else if (event.type == SDL_KEYDOWN) {
-        bool moved = false;
+        int dx = 0;
+        int dy = 0;
         switch (event.key.keysym.sym) {
             case SDLK_UP:
-                moved = player->move(0, -1, currentMaze);
+                dy = -1;
                 break;
             case SDLK_DOWN:
-                moved = player->move(0, 1, currentMaze);
+                dy = 1;
                 break;
             case SDLK_LEFT:
-                moved = player->move(-1, 0, currentMaze);
+                dx = -1;
                 break;
             case SDLK_RIGHT:
-                moved = player->move(1, 0, currentMaze);
+                dx = 1;
                 break;
         }
+        bool moved = (dx != 0 || dy != 0) && player->move(dx, dy, currentMaze);
 
         if (moved) {
             moveCount++;
+            if (!randomMode && !endlessMode) {
+                currentRun.push(static_cast<Maze::Direction>(Maze::directionFromDelta(dx, dy)));
+            }
+            if (endlessMode) {
+                advanceEndless();
+            }
+            markVisited(player->getX(), player->getY());
+            // 距离场下刷新提示只需走一遍剩余路径
+            if (showHint) {
+                calculateHintPath();
+            }
             if (currentMaze->isGoal(player->getX(), player->getY())) {
-                if (currentLevel == maxUnlockedLevel && maxUnlockedLevel < 20) {
-                    maxUnlockedLevel++;
-                    saveGameProgress();
+                // gameTime 只按固定步长增长，到达时补上还没模拟的那部分，用时不再落在 8.33ms 的格点上
+                gameTime += accumulator;
+                if (randomMode) {
+                    maxRandomLevel = std::max(maxRandomLevel, randomLevel);
+                } else {
+                    if (currentLevel == maxUnlockedLevel && maxUnlockedLevel < 20) {
+                        maxUnlockedLevel++;
+                    }
+                    // 记录走法并在刷新最佳时保存进度
+                    recordCompletedRun();
                 }
-                currentState = GameState::LEVEL_COMPLETE;
+                transitionToState(GameState::LEVEL_COMPLETE);
             }
         }
     }
@@ -348,7 +841,7 @@ void Game::handlePlayingEvents(const SDL_Event& event) {
 
 void Game::handleGameOverEvents(const SDL_Event& event) {
     if (event.type == SDL_KEYDOWN) {
-        currentState = GameState::MENU;
+        transitionToState(GameState::MENU);
     }
 }
 
@@ -358,11 +851,19 @@ void Game::handleRandomChallengeEvents(const SDL_Event& event) {
 
 void Game::handleLevelCompleteMouseEvents(const SDL_Event& event) {
     if (event.type == SDL_MOUSEBUTTONDOWN) {
-        int x, y;
-        SDL_GetMouseState(&x, &y);
+        int x = mouseX;
+        int y = mouseY;
 
         if (x >= nextLevelButtonRect.x && x <= (nextLevelButtonRect.x + nextLevelButtonRect.w) &&
             y >= nextLevelButtonRect.y && y <= (nextLevelButtonRect.y + nextLevelButtonRect.h)) {
+            // 随机挑战直接进入下一关（预生成队列里通常已有现成的迷宫）
+            if (randomMode) {
+                randomLevel++;
+                generateRandomLevel();
+                transitionToState(GameState::PLAYING);
+                return;
+            }
+            
             // 更新最高解锁关卡
             if (currentLevel == maxUnlockedLevel && maxUnlockedLevel < 20) {
                 maxUnlockedLevel++;
@@ -374,13 +875,13 @@ void Game::handleLevelCompleteMouseEvents(const SDL_Event& event) {
                 currentLevel = 20;
             }
             loadLevel(currentLevel);
-            currentState = GameState::PLAYING;
+            transitionToState(GameState::PLAYING);
             return;
         }
 
         if (x >= exitButtonRectComplete.x && x <= (exitButtonRectComplete.x + exitButtonRectComplete.w) &&
             y >= exitButtonRectComplete.y && y <= (exitButtonRectComplete.y + exitButtonRectComplete.h)) {
-            currentState = GameState::LEVEL_SELECT;
+            transitionToState(GameState::LEVEL_SELECT);
             return;
         }
     }
@@ -388,13 +889,20 @@ void Game::handleLevelCompleteMouseEvents(const SDL_Event& event) {
 
 void Game::handleMenuMouseEvents(const SDL_Event& event) {
     if (event.type == SDL_MOUSEBUTTONDOWN) {
-        int x, y;
-        SDL_GetMouseState(&x, &y);
+        int x = mouseX;
+        int y = mouseY;
 
         // 检测是否点击在开始按钮上
         if (x >= startButtonRect.x && x <= (startButtonRect.x + startButtonRect.w) &&
             y >= startButtonRect.y && y <= (startButtonRect.y + startButtonRect.h)) {
-            currentState = GameState::LEVEL_SELECT;
+            transitionToState(GameState::LEVEL_SELECT);
+            return;
+        }
+
+        // 设置按钮切换低功耗模式
+        if (x >= settingsButtonRect.x && x <= (settingsButtonRect.x + settingsButtonRect.w) &&
+            y >= settingsButtonRect.y && y <= (settingsButtonRect.y + settingsButtonRect.h)) {
+            setLowPowerMode(!lowPowerMode);
             return;
         }
 
@@ -409,13 +917,13 @@ void Game::handleMenuMouseEvents(const SDL_Event& event) {
 
 void Game::handleLevelSelectMouseEvents(const SDL_Event& event) {
     if (event.type == SDL_MOUSEBUTTONDOWN) {
-        int x, y;
-        SDL_GetMouseState(&x, &y);
+        int x = mouseX;
+        int y = mouseY;
 
         // 检测是否点击在返回按钮上
         if (x >= backButtonRect.x && x <= (backButtonRect.x + backButtonRect.w) &&
             y >= backButtonRect.y && y <= (backButtonRect.y + backButtonRect.h)) {
-            currentState = GameState::MENU;
+            transitionToState(GameState::MENU);
             return;
         }
 
@@ -428,7 +936,7 @@ void Game::handleLevelSelectMouseEvents(const SDL_Event& event) {
                 if(selectedLevel <= maxUnlockedLevel) { // 只能选择已解锁的关卡
                     currentLevel = selectedLevel;  // 设置当前选择的关卡
                     loadLevel(currentLevel);
-                    currentState = GameState::PLAYING;
+                    transitionToState(GameState::PLAYING);
                 }
                 return;
             }
@@ -442,18 +950,18 @@ void Game::renderMenu() {
     
     // 游戏标题区域
     SDL_Rect titleArea = {WINDOW_WIDTH/4, 50, WINDOW_WIDTH/2, 120};
-    Effects::renderBlurPanel(renderer, titleArea);
+    Effects::renderBlurPanel(backend, titleArea);
     
     // 标题文本
     SDL_Color titleColor = {255, 255, 255, 255};
-    TextRenderer::renderText(renderer, "MAZE RUNNER", 
+    TextRenderer::renderText(backend, "MAZE RUNNER", 
                            titleArea.x + titleArea.w/4, 
                            titleArea.y + 40, 
                            titleColor, 48);
 
     // 主菜单按钮区域
     SDL_Rect menuArea = {WINDOW_WIDTH/4, 200, WINDOW_WIDTH/2, 350};
-    Effects::renderBlurPanel(renderer, menuArea);
+    Effects::renderBlurPanel(backend, menuArea);
 
     // 更新按钮位置和大小
     int buttonWidth = 280;
@@ -485,11 +993,12 @@ void Game::renderMenu() {
 
     // 渲染按钮
     renderMenuButton("START GAME", startButtonRect, isMouseOver(startButtonRect));
-    renderMenuButton("SETTINGS", settingsButtonRect, isMouseOver(settingsButtonRect));
+    renderMenuButton(lowPowerMode ? "LOW POWER: ON" : "LOW POWER: OFF",
+                     settingsButtonRect, isMouseOver(settingsButtonRect));
     renderMenuButton("EXIT", exitButtonRect, isMouseOver(exitButtonRect));
 
     // 渲染粒子效果
-    Effects::renderParticles(renderer);
+    Effects::renderParticles(backend);
 }
 
 void Game::renderMenuButton(const std::string& text, SDL_Rect& rect, bool isHighlighted) {
@@ -500,7 +1009,7 @@ void Game::renderMenuButton(const std::string& text, SDL_Rect& rect, bool isHigh
     
     // 如果鼠标按下，稍微移动按钮位置
     static bool isMouseDown = false;
-    if (isHighlighted && SDL_GetMouseState(nullptr, nullptr) & SDL_BUTTON(SDL_BUTTON_LEFT)) {
+    if (isHighlighted && mouseLeftDown) {
         rect.x += 2;
         rect.y += 2;
         isMouseDown = true;
@@ -511,12 +1020,12 @@ void Game::renderMenuButton(const std::string& text, SDL_Rect& rect, bool isHigh
     }
     
     // 渲染圆角矩形按钮
-    Effects::renderRoundedRect(renderer, rect, 10);
+    Effects::renderRoundedRect(backend, rect, 10, bgColor);
     
     // 按钮发光效果
     if (isHighlighted) {
         SDL_Color glowColor = {65, 105, 225, 50};
-        Effects::renderGlow(renderer, rect, glowColor);
+        Effects::renderGlow(backend, rect, glowColor);
     }
     
     // 按钮文本
@@ -524,44 +1033,35 @@ void Game::renderMenuButton(const std::string& text, SDL_Rect& rect, bool isHigh
                          SDL_Color{255, 255, 255, 255} : 
                          SDL_Color{200, 200, 200, 255};
     
-    int textX = rect.x + (rect.w - text.length() * 14) / 2;
+    int textX = rect.x + (rect.w - TextRenderer::measureText(text, 24)) / 2;
     int textY = rect.y + (rect.h - 24) / 2;
     
-    TextRenderer::renderText(renderer, text, textX, textY, textColor, 24);
+    TextRenderer::renderText(backend, text, textX, textY, textColor, 24);
 }
 
 bool Game::isMouseOver(const SDL_Rect& rect) {
-    int x, y;
-    SDL_GetMouseState(&x, &y);
-    return (x >= rect.x && x <= rect.x + rect.w &&
-            y >= rect.y && y <= rect.y + rect.h);
+    return (mouseX >= rect.x && mouseX <= rect.x + rect.w &&
+            mouseY >= rect.y && mouseY <= rect.y + rect.h);
 }
 
 void Game::renderGradientBackground() {
-    // 创建深色渐变背景
-    for(int y = 0; y < WINDOW_HEIGHT; ++y) {
-        float factor = (float)y / WINDOW_HEIGHT;
-        SDL_SetRenderDrawColor(renderer, 
-                             20 + factor * 20, 
-                             20 + factor * 20, 
-                             30 + factor * 30, 
-                             255);
-        SDL_RenderDrawLine(renderer, 0, y, WINDOW_WIDTH, y);
-    }
+    PROFILE_SCOPE("background");
+    // 深色渐变背景，窗口尺寸变化后才重新烘焙
+    AssetCache::renderBackground(backend, WINDOW_WIDTH, WINDOW_HEIGHT);
 }
 
-void Game::renderButton(SDL_Renderer* renderer, 
+void Game::renderButton(RenderBackend* renderer, 
                        const std::string& text, 
                        int x, int y, 
                        SDL_Color color) {
     // 绘制按钮背景
     SDL_Rect buttonRect = {x - 10, y - 5, 220, 40};
-    SDL_SetRenderDrawColor(renderer, 40, 40, 40, 255);
-    SDL_RenderFillRect(renderer, &buttonRect);
+    renderer->setDrawColor(40, 40, 40, 255);
+    renderer->fillRect(&buttonRect);
     
     // 绘制按钮边框
-    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
-    SDL_RenderDrawRect(renderer, &buttonRect);
+    renderer->setDrawColor(color.r, color.g, color.b, color.a);
+    renderer->drawRect(&buttonRect);
     
     // 绘制文本
     TextRenderer::renderText(renderer, text, x, y, color);
@@ -573,41 +1073,32 @@ void Game::renderLevelSelect() {
     
     // 标题区域
     SDL_Rect titleArea = {100, 20, WINDOW_WIDTH - 200, 80};
-    Effects::renderBlurPanel(renderer, titleArea);
+    Effects::renderBlurPanel(backend, titleArea);
     
     // 标题文本
     SDL_Color titleColor = {255, 255, 255, 255};
-    TextRenderer::renderText(renderer, "SELECT LEVEL", 
+    TextRenderer::renderText(backend, "SELECT LEVEL", 
                            titleArea.x + titleArea.w/3, 
                            titleArea.y + 25, 
                            titleColor, 36);
 
     // 关卡选择区域
     SDL_Rect levelArea = {50, 120, WINDOW_WIDTH - 100, 400};
-    Effects::renderBlurPanel(renderer, levelArea);
+    Effects::renderBlurPanel(backend, levelArea);
 
     // 渲染关卡按钮
-    SDL_Color buttonColor = {200, 200, 255, 255};
-    SDL_Color lockedColor = {100, 100, 100, 255};
-    SDL_Color completedColor = {100, 255, 100, 255};
-
     for(int i = 0; i < levelButtonRects.size(); ++i) {
         SDL_Rect& rect = levelButtonRects[i];
         bool isLocked = (i + 1) > maxUnlockedLevel;
-        bool isCompleted = (i + 1) < maxUnlockedLevel;
         bool isHovered = isMouseOver(rect);
         
         // 渲染圆角按钮
-        Effects::renderRoundedRect(renderer, rect, 8);
-        
-        // 按钮颜色
-        SDL_Color color = isLocked ? lockedColor : 
-                         (isCompleted ? completedColor : buttonColor);
+        Effects::renderRoundedRect(backend, rect, 8);
         
         // 发光效果
         if (isHovered && !isLocked) {
             SDL_Color glowColor = {65, 105, 225, 50};
-            Effects::renderGlow(renderer, rect, glowColor);
+            Effects::renderGlow(backend, rect, glowColor);
         }
         
         // 关卡数字
@@ -616,16 +1107,16 @@ void Game::renderLevelSelect() {
                              SDL_Color{150, 150, 150, 255} : 
                              SDL_Color{255, 255, 255, 255};
         
-        int textX = rect.x + (rect.w - levelText.length() * 20) / 2;
+        int textX = rect.x + (rect.w - TextRenderer::measureText(levelText, 24)) / 2;
         int textY = rect.y + (rect.h - 24) / 2;
-        TextRenderer::renderText(renderer, levelText, textX, textY, textColor, 24);
+        TextRenderer::renderText(backend, levelText, textX, textY, textColor, 24);
     }
 
     // 返回按钮
     renderMenuButton("BACK", backButtonRect, isMouseOver(backButtonRect));
     
     // 渲染粒子效果
-    Effects::renderParticles(renderer);
+    Effects::renderParticles(backend);
 }
 
 void Game::renderGame() {
@@ -634,14 +1125,14 @@ void Game::renderGame() {
     
     // 左侧面板
     SDL_Rect leftPanel = {0, 0, 160, WINDOW_HEIGHT};
-    Effects::renderBlurPanel(renderer, leftPanel);
+    Effects::renderBlurPanel(backend, leftPanel);
     
     // 游戏信息面板
     renderGameInfoPanel();
     
     // 迷宫区域
     SDL_Rect mazeArea = mazeRenderArea;
-    Effects::renderBlurPanel(renderer, mazeArea);
+    Effects::renderBlurPanel(backend, mazeArea);
     
     // 渲染迷宫
     renderMaze();
@@ -650,27 +1141,58 @@ void Game::renderGame() {
     renderDynamicLighting();
     
     // 粒子效果
-    Effects::renderParticles(renderer);
+    Effects::renderParticles(backend);
 }
 
 void Game::renderGameInfoPanel() {
     SDL_Color textColor = {255, 255, 255, 255};
     SDL_Color highlightColor = {100, 200, 255, 255};
     
-    // 关卡信息
-    std::string levelText = "LEVEL " + std::to_string(currentLevel);
-    TextRenderer::renderText(renderer, levelText, 20, 30, highlightColor, 28);
+    // 关卡信息（无尽模式显示下潜深度，随机挑战显示挑战关数）
+    std::string levelText = endlessMode ? 
+                            "DEPTH " + std::to_string(endlessDepth) : 
+                            randomMode ? 
+                            "RANDOM " + std::to_string(randomLevel) : 
+                            "LEVEL " + std::to_string(currentLevel);
+    TextRenderer::renderText(backend, levelText, 20, 30, highlightColor, 28);
     
     // 分割线
-    SDL_SetRenderDrawColor(renderer, 100, 100, 150, 100);
-    SDL_RenderDrawLine(renderer, 20, 70, 140, 70);
+    backend->setDrawColor(100, 100, 150, 100);
+    backend->drawLine(20, 70, 140, 70);
     
     // 游戏统计信息
-    TextRenderer::renderText(renderer, "MOVES", 20, 90, textColor, 20);
-    TextRenderer::renderText(renderer, std::to_string(moveCount), 20, 120, highlightColor, 24);
+    TextRenderer::renderText(backend, "MOVES", 20, 90, textColor, 20);
+    TextRenderer::renderText(backend, std::to_string(moveCount), 20, 120, highlightColor, 24);
+    
+    TextRenderer::renderText(backend, "TIME", 20, 160, textColor, 20);
+    TextRenderer::renderText(backend, formatTime(gameTime), 20, 190, highlightColor, 24);
+    
+    // 队列深度和帧时间取决于机器快慢，无窗口和快速回放时不画，保证输出帧可逐帧比对
+    bool deterministicOutput = headless || fastReplay;
     
-    TextRenderer::renderText(renderer, "TIME", 20, 160, textColor, 20);
-    TextRenderer::renderText(renderer, formatTime(gameTime), 20, 190, highlightColor, 24);
+    // 随机挑战时显示预生成队列深度和平均生成耗时，便于调参
+    if (randomMode && pregenerator && !deterministicOutput) {
+        char poolText[48];
+        snprintf(poolText, sizeof(poolText), "POOL %zu  %.1fms",
+                 pregenerator->getQueueDepth(), pregenerator->getAverageLatencyMs());
+        TextRenderer::renderText(backend, poolText, 20, 366, textColor, 14);
+    }
+    
+    // 平均帧时间和抖动
+    if (!deterministicOutput) {
+        char frameText[48];
+        snprintf(frameText, sizeof(frameText), "FRAME %.1fms  +-%.2f",
+                 getAverageFrameTimeMs(), getFrameJitterMs());
+        TextRenderer::renderText(backend, frameText, 20, 384, textColor, 14);
+    }
+    
+    // 统计后端：上一帧的绘制调用和状态切换次数
+    if (drawCounter) {
+        const RenderStats& stats = drawCounter->getLastFrame();
+        char drawText[48];
+        snprintf(drawText, sizeof(drawText), "DRAWS %d  ST %d", stats.drawCalls, stats.stateChanges);
+        TextRenderer::renderText(backend, drawText, 20, 402, textColor, 14);
+    }
     
     // 控制按钮
     renderControlButtons();
@@ -692,9 +1214,10 @@ void Game::renderControlButtons() {
 }
 
 void Game::renderMiniMap() {
+    PROFILE_SCOPE("minimap");
     // 小地图区域
     SDL_Rect miniMapArea = {20, 240, 120, 120};
-    Effects::renderBlurPanel(renderer, miniMapArea);
+    Effects::renderBlurPanel(backend, miniMapArea);
     
     if (!currentMaze) return;
     
@@ -705,23 +1228,35 @@ void Game::renderMiniMap() {
     float startX = miniMapArea.x + (120 - mazeWidth * cellSize) / 2;
     float startY = miniMapArea.y + (120 - mazeHeight * cellSize) / 2;
     
-    // 渲染迷宫缩略图
-    for (int y = 0; y < mazeHeight; y++) {
-        for (int x = 0; x < mazeWidth; x++) {
-            SDL_Rect cell = {
-                static_cast<int>(startX + x * cellSize),
-                static_cast<int>(startY + y * cellSize),
+    // 迷宫缩略图是每格一个像素的纹理，关卡变化时整体重建，
+    // 移动时只修补新访问的格子
+    if (miniMapDirty) {
+        rebuildMiniMap();
+    }
+    if (miniMapTexture) {
+        SDL_Rect dest = {
+            static_cast<int>(startX),
+            static_cast<int>(startY),
+            static_cast<int>(mazeWidth * cellSize),
+            static_cast<int>(mazeHeight * cellSize)
+        };
+        backend->copy(miniMapTexture, nullptr, &dest);
+    } else {
+        // 纹理不可用时退回合并后的墙体矩形
+        WallGeometry::toPixels(wallGeometry.getWallRects(), startX, startY, cellSize, wallPixelRects);
+        backend->setDrawColor(60, 60, 80, 255);
+        backend->fillRects(wallPixelRects.data(), static_cast<int>(wallPixelRects.size()));
+        
+        SDL_Point goal = currentMaze->getGoalPosition();
+        if (currentMaze->isValidPosition(goal.x, goal.y) && !currentMaze->isWall(goal.x, goal.y)) {
+            SDL_Rect goalCell = {
+                static_cast<int>(startX + goal.x * cellSize),
+                static_cast<int>(startY + goal.y * cellSize),
                 static_cast<int>(cellSize),
                 static_cast<int>(cellSize)
             };
-            
-            if (currentMaze->isWall(x, y)) {
-                SDL_SetRenderDrawColor(renderer, 60, 60, 80, 255);
-                SDL_RenderFillRect(renderer, &cell);
-            } else if (currentMaze->isGoal(x, y)) {
-                SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
-                SDL_RenderFillRect(renderer, &cell);
-            }
+            backend->setDrawColor(0, 255, 0, 255);
+            backend->fillRect(&goalCell);
         }
     }
     
@@ -732,11 +1267,11 @@ void Game::renderMiniMap() {
         static_cast<int>(cellSize),
         static_cast<int>(cellSize)
     };
-    SDL_SetRenderDrawColor(renderer, 255, 100, 100, 255);
-    SDL_RenderFillRect(renderer, &playerPos);
+    backend->setDrawColor(255, 100, 100, 255);
+    backend->fillRect(&playerPos);
 }
 
-std::string Game::formatTime(float seconds) {
+std::string Game::formatTime(double seconds) {
     int minutes = static_cast<int>(seconds) / 60;
     int secs = static_cast<int>(seconds) % 60;
     char buffer[10];
@@ -745,56 +1280,42 @@ std::string Game::formatTime(float seconds) {
 }
 
 void Game::renderMaze() {
+    PROFILE_SCOPE("maze");
     if (!currentMaze || !player) return;
     
-    int mazeWidth = currentMaze->getWidth();
-    int mazeHeight = currentMaze->getHeight();
-    
-    // 计算单元格大小
-    float cellWidth = static_cast<float>(mazeRenderArea.w) / mazeWidth;
-    float cellHeight = static_cast<float>(mazeRenderArea.h) / mazeHeight;
-    float cellSize = std::min(cellWidth, cellHeight);
+    // 单元格大小和世界原点由摄像机决定
+    float cellSize = camera.getCellSize();
+    float offsetX = camera.getOffsetX();
+    float offsetY = camera.getOffsetY();
     
-    // 计算居中偏移
-    float offsetX = mazeRenderArea.x + (mazeRenderArea.w - cellSize * mazeWidth) / 2;
-    float offsetY = mazeRenderArea.y + (mazeRenderArea.h - cellSize * mazeHeight) / 2;
+    // 放大后迷宫会超出区域，裁剪到迷宫区域内
+    backend->setClipRect(&mazeRenderArea);
     
-    // 渲染迷宫
-    for (int y = 0; y < mazeHeight; y++) {
-        for (int x = 0; x < mazeWidth; x++) {
-            SDL_Rect cell = {
-                static_cast<int>(offsetX + x * cellSize),
-                static_cast<int>(offsetY + y * cellSize),
-                static_cast<int>(cellSize + 1), // 添加1像素重叠
-                static_cast<int>(cellSize + 1)  // 添加1像素重叠
-            };
-            
-            if (currentMaze->isWall(x, y)) {
-                // 墙壁
-                SDL_SetRenderDrawColor(renderer, 40, 40, 60, 255);
-                SDL_RenderFillRect(renderer, &cell);
-                // 墙壁阴影效果
-                Effects::renderWallShadow(renderer, cell);
-            } else if (currentMaze->isGoal(x, y)) {
-                // 终点
-                SDL_SetRenderDrawColor(renderer, 0, 200, 100, 255);
-                SDL_RenderFillRect(renderer, &cell);
-                // 终点发光效果
-                Effects::renderGlow(renderer, cell, {0, 255, 100, 50});
-            } else {
-                // 路径
-                SDL_SetRenderDrawColor(renderer, 60, 60, 80, 255);
-                SDL_RenderFillRect(renderer, &cell);
-            }
+    if (camera.isFitView()) {
+        // 静态层（地面、墙壁、阴影、终点）只在关卡变化或窗口尺寸变化时重绘，
+        // 之后每帧只拷贝一次纹理
+        if (mazeLayerDirty) {
+            rebuildMazeLayer();
         }
+        if (mazeLayerTexture) {
+            backend->copy(mazeLayerTexture, nullptr, &mazeRenderArea);
+        } else {
+            // 不支持渲染目标时退回逐格绘制
+            drawMazeGeometry(offsetX, offsetY, cellSize);
+        }
+    } else {
+        // 放大时只绘制视口内的格子，开销与迷宫大小无关
+        int firstX, firstY, lastX, lastY;
+        camera.getVisibleCells(firstX, firstY, lastX, lastY);
+        drawVisibleCells(firstX, firstY, lastX, lastY, offsetX, offsetY, cellSize);
     }
     
     // 渲染提示路径（确保在玩家下方）
     if (showHint && !hintPath.empty()) {
-        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+        backend->setDrawBlendMode(SDL_BLENDMODE_BLEND);
         
         // 首先渲染路径的主体
-        SDL_SetRenderDrawColor(renderer, 255, 215, 0, 80);
+        backend->setDrawColor(255, 215, 0, 80);
         
         // 创建一个稍大的矩形来覆盖整个路径区域
         SDL_Rect pathRect = {
@@ -825,7 +1346,7 @@ void Game::renderMaze() {
                 static_cast<int>(cellSize),
                 static_cast<int>(cellSize)
             };
-            SDL_RenderFillRect(renderer, &cellRect);
+            backend->fillRect(&cellRect);
             
             // 如果不是最后一个点，渲染连接
             if (i < hintPath.size() - 1) {
@@ -839,7 +1360,7 @@ void Game::renderMaze() {
                         static_cast<int>(cellSize),
                         static_cast<int>(std::abs(nextPoint.y - point.y) * cellSize + cellSize)
                     };
-                    SDL_RenderFillRect(renderer, &connector);
+                    backend->fillRect(&connector);
                 } else { // 水平连接
                     SDL_Rect connector = {
                         static_cast<int>(offsetX + std::min(point.x, nextPoint.x) * cellSize),
@@ -847,13 +1368,13 @@ void Game::renderMaze() {
                         static_cast<int>(std::abs(nextPoint.x - point.x) * cellSize + cellSize),
                         static_cast<int>(cellSize)
                     };
-                    SDL_RenderFillRect(renderer, &connector);
+                    backend->fillRect(&connector);
                 }
             }
         }
         
         // 添加柔和的边缘效果
-        SDL_SetRenderDrawColor(renderer, 255, 235, 100, 30);
+        backend->setDrawColor(255, 235, 100, 30);
         for (const auto& point : hintPath) {
             SDL_Rect edgeRect = {
                 static_cast<int>(offsetX + point.x * cellSize) - 1,
@@ -861,10 +1382,21 @@ void Game::renderMaze() {
                 static_cast<int>(cellSize + 2),
                 static_cast<int>(cellSize + 2)
             };
-            SDL_RenderDrawRect(renderer, &edgeRect);
+            backend->drawRect(&edgeRect);
         }
     }
     
+    // 幽灵：按最佳一局的节奏重放，画在玩家下面
+    if (currentBestRun()) {
+        SDL_Rect ghostRect = {
+            static_cast<int>(offsetX + ghostX * cellSize),
+            static_cast<int>(offsetY + ghostY * cellSize),
+            static_cast<int>(cellSize),
+            static_cast<int>(cellSize)
+        };
+        Effects::renderRoundedRect(backend, ghostRect, static_cast<int>(cellSize/4), {150, 180, 255, 90});
+    }
+    
     // 渲染玩家
     SDL_Rect playerRect = {
         static_cast<int>(offsetX + player->getX() * cellSize),
@@ -874,17 +1406,239 @@ void Game::renderMaze() {
     };
     
     // 玩家发光效果
-    Effects::renderGlow(renderer, playerRect, {255, 100, 100, 50});
+    Effects::renderGlow(backend, playerRect, {255, 100, 100, 50});
     
     // 玩家主体
-    SDL_SetRenderDrawColor(renderer, 255, 100, 100, 255);
-    Effects::renderRoundedRect(renderer, playerRect, static_cast<int>(cellSize/4));
+    Effects::renderRoundedRect(backend, playerRect, static_cast<int>(cellSize/4), {255, 100, 100, 255});
+    
+    backend->setClipRect(nullptr);
+}
+
+void Game::drawMazeGeometry(float offsetX, float offsetY, float cellSize) {
+    // 合并后的矩形在关卡加载时已算好，这里只做像素换算，每种颜色提交一次
+    WallGeometry::toPixels(wallGeometry.getFloorRects(), offsetX, offsetY, cellSize, floorPixelRects);
+    WallGeometry::toPixels(wallGeometry.getWallRects(), offsetX, offsetY, cellSize, wallPixelRects);
+    WallGeometry::buildShadows(wallPixelRects, shadowPixelRects);
+    
+    // 路径
+    backend->setDrawBlendMode(SDL_BLENDMODE_NONE);
+    backend->setDrawColor(60, 60, 80, 255);
+    backend->fillRects(floorPixelRects.data(), static_cast<int>(floorPixelRects.size()));
+    
+    // 终点
+    SDL_Point goal = currentMaze->getGoalPosition();
+    if (currentMaze->isValidPosition(goal.x, goal.y) && !currentMaze->isWall(goal.x, goal.y)) {
+        SDL_Rect goalRect = {
+            static_cast<int>(offsetX + goal.x * cellSize),
+            static_cast<int>(offsetY + goal.y * cellSize),
+            static_cast<int>(offsetX + (goal.x + 1) * cellSize) - static_cast<int>(offsetX + goal.x * cellSize),
+            static_cast<int>(offsetY + (goal.y + 1) * cellSize) - static_cast<int>(offsetY + goal.y * cellSize)
+        };
+        backend->setDrawColor(0, 200, 100, 255);
+        backend->fillRect(&goalRect);
+        // 终点发光效果
+        Effects::renderGlow(backend, goalRect, {0, 255, 100, 50});
+    }
+    
+    // 墙壁阴影先画，落在相邻墙上的部分随后被墙体覆盖
+    backend->setDrawBlendMode(SDL_BLENDMODE_BLEND);
+    backend->setDrawColor(0, 0, 0, 100);
+    backend->fillRects(shadowPixelRects.data(), static_cast<int>(shadowPixelRects.size()));
+    
+    // 墙壁
+    backend->setDrawColor(40, 40, 60, 255);
+    backend->fillRects(wallPixelRects.data(), static_cast<int>(wallPixelRects.size()));
+}
+
+Uint32 Game::miniMapColorAt(int x, int y) const {
+    // RGBA8888：0xRRGGBBAA，地面透明以露出面板
+    if (currentMaze->isWall(x, y)) return 0x3C3C50FF;
+    if (currentMaze->isGoal(x, y)) return 0x00FF00FF;
+    if (visitedCells[static_cast<size_t>(y) * currentMaze->getWidth() + x]) return 0x64648CFF;
+    return 0x00000000;
+}
+
+void Game::rebuildMiniMap() {
+    miniMapDirty = false;
+    int mazeWidth = currentMaze->getWidth();
+    int mazeHeight = currentMaze->getHeight();
+    
+    int textureWidth = 0;
+    int textureHeight = 0;
+    if (miniMapTexture) {
+        SDL_QueryTexture(miniMapTexture, nullptr, nullptr, &textureWidth, &textureHeight);
+    }
+    if (!miniMapTexture || textureWidth != mazeWidth || textureHeight != mazeHeight) {
+        if (miniMapTexture) {
+            SDL_DestroyTexture(miniMapTexture);
+        }
+        miniMapTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888,
+                                           SDL_TEXTUREACCESS_STREAMING, mazeWidth, mazeHeight);
+        if (!miniMapTexture) {
+            std::cerr << "Failed to create minimap texture: " << SDL_GetError() << std::endl;
+            return;
+        }
+        SDL_SetTextureBlendMode(miniMapTexture, SDL_BLENDMODE_BLEND);
+        // 放大时保持像素边缘清晰
+        SDL_SetTextureScaleMode(miniMapTexture, SDL_ScaleModeNearest);
+    }
+    
+    miniMapPixels.resize(static_cast<size_t>(mazeWidth) * mazeHeight);
+    for (int y = 0; y < mazeHeight; y++) {
+        for (int x = 0; x < mazeWidth; x++) {
+            miniMapPixels[static_cast<size_t>(y) * mazeWidth + x] = miniMapColorAt(x, y);
+        }
+    }
+    SDL_UpdateTexture(miniMapTexture, nullptr, miniMapPixels.data(),
+                      mazeWidth * static_cast<int>(sizeof(Uint32)));
+}
+
+void Game::resetLevelView() {
+    visitedCells.assign(static_cast<size_t>(currentMaze->getWidth()) * currentMaze->getHeight(), 0);
+    visitedCells[static_cast<size_t>(player->getY()) * currentMaze->getWidth() + player->getX()] = 1;
+    miniMapDirty = true;
+    
+    // 新关卡从默认缩放开始，镜头直接对准玩家
+    camera.setWorldSize(currentMaze->getWidth(), currentMaze->getHeight());
+    camera.resetZoom();
+    camera.follow(player->getX() + 0.5f, player->getY() + 0.5f);
+    camera.snapToTarget();
+}
+
+void Game::scrollVisitedCells(int cellRows) {
+    // 无尽模式窗口上移时，已访问标记跟着上移，底部补零
+    size_t rowSize = static_cast<size_t>(currentMaze->getWidth());
+    size_t shift = std::min(visitedCells.size(), rowSize * cellRows);
+    std::move(visitedCells.begin() + shift, visitedCells.end(), visitedCells.begin());
+    std::fill(visitedCells.end() - shift, visitedCells.end(), 0);
+    miniMapDirty = true;
+}
+
+void Game::markVisited(int x, int y) {
+    if (!currentMaze->isValidPosition(x, y)) return;
+    size_t index = static_cast<size_t>(y) * currentMaze->getWidth() + x;
+    if (index >= visitedCells.size() || visitedCells[index]) return;
+    visitedCells[index] = 1;
+    
+    // 纹理已是最新时只上传这一个像素
+    if (miniMapTexture && !miniMapDirty && index < miniMapPixels.size()) {
+        miniMapPixels[index] = miniMapColorAt(x, y);
+        SDL_Rect pixel = {x, y, 1, 1};
+        SDL_UpdateTexture(miniMapTexture, &pixel, &miniMapPixels[index],
+                          currentMaze->getWidth() * static_cast<int>(sizeof(Uint32)));
+    }
+}
+
+void Game::drawVisibleCells(int firstX, int firstY, int lastX, int lastY,
+                            float offsetX, float offsetY, float cellSize) {
+    floorPixelRects.clear();
+    wallPixelRects.clear();
+    
+    // 每行把相同类型的连续格子合成一段，按颜色批量提交
+    for (int y = firstY; y < lastY; y++) {
+        int top = static_cast<int>(offsetY + y * cellSize);
+        int bottom = static_cast<int>(offsetY + (y + 1) * cellSize);
+        int index = currentMaze->toIndex(firstX, y);
+        int x = firstX;
+        while (x < lastX) {
+            bool wall = currentMaze->isWallAt(index);
+            int runStart = x;
+            do {
+                x++;
+                index++;
+            } while (x < lastX && currentMaze->isWallAt(index) == wall);
+            
+            int left = static_cast<int>(offsetX + runStart * cellSize);
+            int right = static_cast<int>(offsetX + x * cellSize);
+            (wall ? wallPixelRects : floorPixelRects).push_back({left, top, right - left, bottom - top});
+        }
+    }
+    WallGeometry::buildShadows(wallPixelRects, shadowPixelRects);
+    
+    // 路径
+    backend->setDrawBlendMode(SDL_BLENDMODE_NONE);
+    backend->setDrawColor(60, 60, 80, 255);
+    backend->fillRects(floorPixelRects.data(), static_cast<int>(floorPixelRects.size()));
+    
+    // 终点（在可见范围内才画）
+    SDL_Point goal = currentMaze->getGoalPosition();
+    if (goal.x >= firstX && goal.x < lastX && goal.y >= firstY && goal.y < lastY &&
+        !currentMaze->isWall(goal.x, goal.y)) {
+        SDL_Rect goalRect = {
+            static_cast<int>(offsetX + goal.x * cellSize),
+            static_cast<int>(offsetY + goal.y * cellSize),
+            static_cast<int>(offsetX + (goal.x + 1) * cellSize) - static_cast<int>(offsetX + goal.x * cellSize),
+            static_cast<int>(offsetY + (goal.y + 1) * cellSize) - static_cast<int>(offsetY + goal.y * cellSize)
+        };
+        backend->setDrawColor(0, 200, 100, 255);
+        backend->fillRect(&goalRect);
+        Effects::renderGlow(backend, goalRect, {0, 255, 100, 50});
+    }
+    
+    backend->setDrawBlendMode(SDL_BLENDMODE_BLEND);
+    backend->setDrawColor(0, 0, 0, 100);
+    backend->fillRects(shadowPixelRects.data(), static_cast<int>(shadowPixelRects.size()));
+    
+    backend->setDrawColor(40, 40, 60, 255);
+    backend->fillRects(wallPixelRects.data(), static_cast<int>(wallPixelRects.size()));
+}
+
+void Game::onMazeChanged() {
+    wallGeometry.build(*currentMaze);
+    invalidateMazeLayer();
+}
+
+void Game::invalidateMazeLayer() {
+    mazeLayerDirty = true;
+}
+
+void Game::rebuildMazeLayer() {
+    mazeLayerDirty = false;
+    if (!SDL_RenderTargetSupported(renderer)) return;
+    
+    // 纹理覆盖整个迷宫区域，尺寸变化时重新创建
+    int textureWidth = 0;
+    int textureHeight = 0;
+    if (mazeLayerTexture) {
+        SDL_QueryTexture(mazeLayerTexture, nullptr, nullptr, &textureWidth, &textureHeight);
+    }
+    if (!mazeLayerTexture || textureWidth != mazeRenderArea.w || textureHeight != mazeRenderArea.h) {
+        if (mazeLayerTexture) {
+            SDL_DestroyTexture(mazeLayerTexture);
+        }
+        mazeLayerTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888,
+                                             SDL_TEXTUREACCESS_TARGET,
+                                             mazeRenderArea.w, mazeRenderArea.h);
+        if (!mazeLayerTexture) {
+            std::cerr << "Failed to create maze layer texture: " << SDL_GetError() << std::endl;
+            return;
+        }
+        SDL_SetTextureBlendMode(mazeLayerTexture, SDL_BLENDMODE_BLEND);
+    }
+    
+    int mazeWidth = currentMaze->getWidth();
+    int mazeHeight = currentMaze->getHeight();
+    float cellSize = std::min(static_cast<float>(mazeRenderArea.w) / mazeWidth,
+                              static_cast<float>(mazeRenderArea.h) / mazeHeight);
+    
+    // 在纹理坐标系中绘制，透明背景保留下面的面板
+    SDL_Texture* previousTarget = backend->getTarget();
+    backend->setTarget(mazeLayerTexture);
+    backend->setDrawBlendMode(SDL_BLENDMODE_NONE);
+    backend->setDrawColor(0, 0, 0, 0);
+    backend->clear();
+    
+    drawMazeGeometry((mazeRenderArea.w - cellSize * mazeWidth) / 2,
+                  (mazeRenderArea.h - cellSize * mazeHeight) / 2,
+                  cellSize);
+    
+    backend->setTarget(previousTarget);
 }
 
 void Game::renderGameOver() {
     SDL_Color white = {255, 255, 255, 255};
-    TextRenderer::renderText(renderer, "CONGRATULATIONS!", 350, 250, white, 36);
-    TextRenderer::renderText(renderer, "PRESS ANY KEY TO RETURN", 300, 350, white);
+    TextRenderer::renderText(backend, "CONGRATULATIONS!", 350, 250, white, 36);
+    TextRenderer::renderText(backend, "PRESS ANY KEY TO RETURN", 300, 350, white);
 }
 
 void Game::renderLevelComplete() {
@@ -892,18 +1646,18 @@ void Game::renderLevelComplete() {
     renderGradientBackground();
     
     // 全屏半透明遮罩
-    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 200);
+    backend->setDrawBlendMode(SDL_BLENDMODE_BLEND);
+    backend->setDrawColor(0, 0, 0, 200);
     SDL_Rect fullScreen = {0, 0, WINDOW_WIDTH, WINDOW_HEIGHT};
-    SDL_RenderFillRect(renderer, &fullScreen);
+    backend->fillRect(&fullScreen);
     
     // 完成信息面板（充满屏幕）
     SDL_Rect completePanel = {50, 50, WINDOW_WIDTH - 100, WINDOW_HEIGHT - 100};
-    Effects::renderBlurPanel(renderer, completePanel);
+    Effects::renderBlurPanel(backend, completePanel);
     
     // 标题
     SDL_Color titleColor = {255, 255, 255, 255};
-    TextRenderer::renderText(renderer, "LEVEL COMPLETE!", 
+    TextRenderer::renderText(backend, "LEVEL COMPLETE!", 
                            completePanel.x + completePanel.w/3, 
                            completePanel.y + 60, 
                            titleColor, 48);
@@ -915,25 +1669,37 @@ void Game::renderLevelComplete() {
     int infoY = completePanel.y + 180;
     
     // 移动次数
-    TextRenderer::renderText(renderer, "Moves:", 
+    TextRenderer::renderText(backend, "Moves:", 
                            completePanel.x + 200, 
                            infoY, 
                            textColor, 32);
-    TextRenderer::renderText(renderer, std::to_string(moveCount), 
+    TextRenderer::renderText(backend, std::to_string(moveCount), 
                            completePanel.x + 500, 
                            infoY, 
                            valueColor, 32);
     
     // 完成时间
-    TextRenderer::renderText(renderer, "Time:", 
+    TextRenderer::renderText(backend, "Time:", 
                            completePanel.x + 200, 
-                           infoY + 60, 
+                           infoY + 50, 
                            textColor, 32);
-    TextRenderer::renderText(renderer, formatTime(gameTime), 
+    TextRenderer::renderText(backend, formatTime(gameTime), 
                            completePanel.x + 500, 
-                           infoY + 60, 
+                           infoY + 50, 
                            valueColor, 32);
     
+    // 最优步数（来自终点距离场）
+    if (optimalMoves >= 0) {
+        TextRenderer::renderText(backend, "Optimal:", 
+                               completePanel.x + 200, 
+                               infoY + 100, 
+                               textColor, 32);
+        TextRenderer::renderText(backend, std::to_string(optimalMoves), 
+                               completePanel.x + 500, 
+                               infoY + 100, 
+                               valueColor, 32);
+    }
+    
     // 竖直排列按钮
     int buttonWidth = 300;
     int buttonHeight = 60;
@@ -962,30 +1728,126 @@ void Game::renderLevelComplete() {
                     isMouseOver(exitButtonRectComplete));
     
     // 添加粒子效果
-    Effects::renderParticles(renderer);
+    Effects::renderParticles(backend);
 }
 
 void Game::saveGameProgress() {
-    std::ofstream file("save/progress.dat", std::ios::binary);
-    if (file.is_open()) {
-        file.write(reinterpret_cast<const char*>(&maxUnlockedLevel), sizeof(maxUnlockedLevel));
-        file.close();
+    if (!persistProgress) {
+        return;
+    }
+    // 在主线程打包成内存快照，写盘交给存档线程
+    std::ostringstream file(std::ios::binary);
+    file.write(reinterpret_cast<const char*>(&maxUnlockedLevel), sizeof(maxUnlockedLevel));
+    
+    // 之后是各关最佳走法：数量，再逐条写关卡号、用时和打包的移动
+    uint32_t runCount = static_cast<uint32_t>(bestRuns.size());
+    file.write(reinterpret_cast<const char*>(&runCount), sizeof(runCount));
+    for (const auto& entry : bestRuns) {
+        int32_t level = entry.first;
+        file.write(reinterpret_cast<const char*>(&level), sizeof(level));
+        file.write(reinterpret_cast<const char*>(&entry.second.time), sizeof(entry.second.time));
+        entry.second.moves.write(file);
     }
+    
+    saveWorker->requestWrite("save/progress.dat", file.str());
 }
 
 void Game::loadGameProgress() {
     std::ifstream file("save/progress.dat", std::ios::binary);
     if (file.is_open()) {
         file.read(reinterpret_cast<char*>(&maxUnlockedLevel), sizeof(maxUnlockedLevel));
+        
+        // 旧存档只有解锁关卡，读不到最佳走法时保持为空
+        bestRuns.clear();
+        uint32_t runCount = 0;
+        if (file.read(reinterpret_cast<char*>(&runCount), sizeof(runCount))) {
+            for (uint32_t i = 0; i < runCount; i++) {
+                int32_t level = 0;
+                BestRun run;
+                if (!file.read(reinterpret_cast<char*>(&level), sizeof(level)) ||
+                    !file.read(reinterpret_cast<char*>(&run.time), sizeof(run.time)) ||
+                    !run.moves.read(file)) {
+                    std::cerr << "Best runs in save/progress.dat are truncated" << std::endl;
+                    break;
+                }
+                bestRuns[level] = std::move(run);
+            }
+        }
         file.close();
     } else {
         // 如果文件不存在，创建目录和文件
-        system("mkdir -p save");
+        std::error_code error;
+        std::filesystem::create_directories("save", error);
+        if (error) {
+            std::cerr << "Cannot create save directory: " << error.message() << std::endl;
+        }
         maxUnlockedLevel = 1;
         saveGameProgress();
     }
 }
 
+void Game::recordCompletedRun() {
+    appendRunHistory(currentLevel, currentRun, gameTime);
+    
+    // 步数少者优先，步数相同比用时
+    auto it = bestRuns.find(currentLevel);
+    bool better = it == bestRuns.end() ||
+                  currentRun.size() < it->second.moves.size() ||
+                  (currentRun.size() == it->second.moves.size() && gameTime < it->second.time);
+    if (better) {
+        BestRun& best = bestRuns[currentLevel];
+        best.moves = currentRun;
+        best.time = gameTime;
+    }
+    saveGameProgress();
+}
+
+void Game::appendRunHistory(int level, const MoveLog& moves, double time) {
+    if (!persistProgress) {
+        return;
+    }
+    std::ostringstream record(std::ios::binary);
+    int32_t storedLevel = level;
+    record.write(reinterpret_cast<const char*>(&storedLevel), sizeof(storedLevel));
+    record.write(reinterpret_cast<const char*>(&time), sizeof(time));
+    moves.write(record);
+    saveWorker->requestAppend("save/runs.dat", record.str());
+}
+
+const Game::BestRun* Game::currentBestRun() const {
+    // 幽灵来自本机存档，无窗口和回放时不显示，输出帧不随存档内容变化
+    if (randomMode || endlessMode || headless || replayingInput) {
+        return nullptr;
+    }
+    auto it = bestRuns.find(currentLevel);
+    if (it == bestRuns.end() || it->second.moves.empty()) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+void Game::resetGhost() {
+    ghostX = 1;
+    ghostY = 1;
+    ghostStep = 0;
+}
+
+void Game::updateGhost() {
+    const BestRun* best = currentBestRun();
+    if (!best) {
+        return;
+    }
+    // 按最佳一局的平均步速推进，每帧只解码新走过的几步
+    size_t total = best->moves.size();
+    double stepTime = std::max(best->time / static_cast<double>(total), MIN_GHOST_STEP_TIME);
+    size_t target = std::min(total, static_cast<size_t>(gameTime / stepTime));
+    while (ghostStep < target) {
+        Maze::Direction direction = best->moves.at(ghostStep++);
+        ghostX += Maze::DIRECTION_DX[direction];
+        ghostY += Maze::DIRECTION_DY[direction];
+    }
+}
+
 void Game::updateProgress() {
     // 如果完成当前关卡，解锁下一关
     if (currentState == GameState::LEVEL_COMPLETE) {
@@ -1009,12 +1871,21 @@ bool Game::loadLevel(int level) {
         }
         
         // 重置玩家位置和游戏统计
+        endlessMode = false;
+        randomMode = false;
         player->setPosition(1, 1);
         player->setMaze(currentMaze);
+        pathFinder.reset(*currentMaze);
+        currentMaze->buildDistanceField();
+        onMazeChanged();
+        resetLevelView();
+        optimalMoves = currentMaze->getDistanceToGoal(1, 1);
         currentLevel = level;
         moveCount = 0;
-        gameTime = 0.0f;
+        gameTime = 0.0;
         showHint = false;
+        currentRun.clear();
+        resetGhost();
         
         return true;
     } catch (const std::exception& e) {
@@ -1023,31 +1894,197 @@ bool Game::loadLevel(int level) {
     }
 }
 
-void Game::generateRandomLevel() {
-    int size = 3 + (maxRandomLevel - 1) * 2;
+int Game::randomLevelSize(int level) {
+    int size = 3 + (level - 1) * 2;
     if (size > 10) size = 10;
-    currentMaze->generateRandomMaze(size);
+    return size;
+}
+
+void Game::generateRandomLevel() {
+    int size = randomLevelSize(randomLevel);
+    endlessMode = false;
+    randomMode = true;
+    
+    // 优先从预生成队列取现成的迷宫，只需交换指针；没有时才同步生成
+    // 回放时必须用录制的种子同步生成
+    uint32_t seed;
+    std::unique_ptr<Maze> ready;
+    if (takeReplaySeed(seed)) {
+        currentMaze->generateRandomMaze(size, MazeAlgorithm::DFS, seed);
+        currentMaze->buildDistanceField();
+    } else {
+        ready = pregenerator ? pregenerator->take(size) : nullptr;
+        if (ready) {
+            delete currentMaze;
+            currentMaze = ready.release();
+        } else {
+            currentMaze->generateRandomMaze(size);
+            currentMaze->buildDistanceField();
+        }
+    }
+    recordSeed(currentMaze->getSeed());
+    
+    // 让工作线程准备接下来两关
+    if (pregenerator) {
+        pregenerator->setUpcomingSizes({randomLevelSize(randomLevel + 1),
+                                        randomLevelSize(randomLevel + 2)});
+    }
+    
+    player->setMaze(currentMaze);
     player->setPosition(1, 1);
+    onMazeChanged();
+    resetLevelView();
+    moveCount = 0;
+    gameTime = 0.0;
+    showHint = false;
+    hintPath.clear();
+    optimalMoves = currentMaze->getDistanceToGoal(1, 1);
+}
+
+void Game::startEndlessMode() {
+    if (!currentMaze || !player) return;
+    
+    // 每次开局换一个种子；窗口大小固定，内存不随前进距离增长
+    uint32_t seed;
+    if (!takeReplaySeed(seed)) {
+        seed = static_cast<uint32_t>(SDL_GetPerformanceCounter());
+    }
+    recordSeed(seed);
+    delete endlessStream;
+    endlessStream = new EllerMazeStream(seed);
+    currentMaze->generateEndlessWindow(ENDLESS_WIDTH, ENDLESS_WINDOW_HEIGHT, *endlessStream);
+    
+    endlessMode = true;
+    endlessDepth = 0;
+    moveCount = 0;
+    gameTime = 0.0;
+    showHint = false;
+    optimalMoves = -1;
+    hintPath.clear();
+    player->setMaze(currentMaze);
+    player->setPosition(1, 1);
+    onMazeChanged();
+    resetLevelView();
+}
+
+void Game::advanceEndless() {
+    if (!endlessStream) return;
+    
+    // 玩家越过窗口下部三分之一时，把窗口上移到玩家位于上部三分之一；
+    // 每行生成只需 O(宽度)，不会造成卡顿
+    int threshold = ENDLESS_WINDOW_HEIGHT * 2 / 3;
+    if (player->getY() < threshold) return;
+    
+    int roomRows = (player->getY() - ENDLESS_WINDOW_HEIGHT / 3) / 2;
+    int shifted = endlessStream->advance(*currentMaze, roomRows);
+    endlessDepth += shifted / 2;
+    player->setPosition(player->getX(), player->getY() - shifted);
+    scrollVisitedCells(shifted);
+    camera.translate(0.0f, static_cast<float>(-shifted));
+    onMazeChanged();
 }
 
 void Game::transitionToState(GameState newState) {
-    // 淡出效果
-    for(int alpha = 0; alpha < 255; alpha += 5) {
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, alpha);
-        SDL_RenderFillRect(renderer, nullptr);
-        SDL_RenderPresent(renderer);
-        SDL_Delay(1);
+    if (newState == currentState) return;
+    
+    // 上一帧的画面留作旧状态的快照，在新状态之上淡出；
+    // 状态立即切换，事件和模拟照常进行
+    if (frameTexture && snapshotTexture) {
+        std::swap(frameTexture, snapshotTexture);
+        transitionActive = true;
+        transitionTime = 0.0;
     }
-    
     currentState = newState;
     
-    // 淡入效果
-    for(int alpha = 255; alpha > 0; alpha -= 5) {
+    // 快照还完全不透明时准备好新状态的资源，重建开销被遮住
+    prepareStateAssets(newState);
+}
+
+void Game::prepareStateAssets(GameState state) {
+    if (state != GameState::PLAYING || !currentMaze) return;
+    
+    if (mazeLayerDirty) {
+        rebuildMazeLayer();
+    }
+    if (miniMapDirty) {
+        rebuildMiniMap();
+    }
+    if (showHint) {
+        calculateHintPath();
+    }
+}
+
+bool Game::ensureFrameTextures() {
+    int outputWidth = 0;
+    int outputHeight = 0;
+    backend->getOutputSize(&outputWidth, &outputHeight);
+    if (frameTexture && outputWidth == frameTextureWidth && outputHeight == frameTextureHeight) {
+        return true;
+    }
+    releaseFrameTextures();
+    if (!SDL_RenderTargetSupported(renderer) || outputWidth <= 0 || outputHeight <= 0) {
+        return false;
+    }
+    
+    frameTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888,
+                                     SDL_TEXTUREACCESS_TARGET, outputWidth, outputHeight);
+    snapshotTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888,
+                                        SDL_TEXTUREACCESS_TARGET, outputWidth, outputHeight);
+    if (!frameTexture || !snapshotTexture) {
+        std::cerr << "Failed to create frame textures: " << SDL_GetError() << std::endl;
+        releaseFrameTextures();
+        return false;
+    }
+    frameTextureWidth = outputWidth;
+    frameTextureHeight = outputHeight;
+    return true;
+}
+
+void Game::releaseFrameTextures() {
+    if (frameTexture) {
+        SDL_DestroyTexture(frameTexture);
+        frameTexture = nullptr;
+    }
+    if (snapshotTexture) {
+        SDL_DestroyTexture(snapshotTexture);
+        snapshotTexture = nullptr;
+    }
+    frameTextureWidth = 0;
+    frameTextureHeight = 0;
+    // 过渡被取消时同样需要重画，否则屏幕上停留着半透明的快照
+    if (transitionActive) {
+        transitionActive = false;
+        needsRedraw = true;
+    }
+}
+
+void Game::renderFrame() {
+    PROFILE_SCOPE("frame");
+    // 不支持渲染目标时直接画到屏幕，状态切换没有过渡
+    if (!ensureFrameTextures()) {
+        backend->setDrawColor(20, 20, 30, 255);
+        backend->clear();
         render();
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, alpha);
-        SDL_RenderFillRect(renderer, nullptr);
-        SDL_RenderPresent(renderer);
-        SDL_Delay(1);
+        return;
+    }
+    
+    // 当前状态画进帧纹理，切换状态时它就是旧状态的快照
+    backend->setTarget(frameTexture);
+    backend->setDrawColor(20, 20, 30, 255);
+    backend->clear();
+    render();
+    backend->setTarget(nullptr);
+    
+    SDL_SetTextureBlendMode(frameTexture, SDL_BLENDMODE_NONE);
+    backend->copy(frameTexture, nullptr, nullptr);
+    
+    if (transitionActive) {
+        // 平滑曲线：开始和结束时变化较慢
+        double t = std::min(transitionTime / TRANSITION_DURATION, 1.0);
+        double fade = 1.0 - t * t * (3.0 - 2.0 * t);
+        SDL_SetTextureBlendMode(snapshotTexture, SDL_BLENDMODE_BLEND);
+        SDL_SetTextureAlphaMod(snapshotTexture, static_cast<Uint8>(fade * 255));
+        backend->copy(snapshotTexture, nullptr, nullptr);
     }
 }
 
@@ -1064,45 +2101,12 @@ void Game::loadResources() {
 
 void Game::renderButtonGlow(const SDL_Rect& rect) {
     SDL_Color glowColor = {65, 105, 225, 100}; // 蓝色发光效果
-    Effects::renderGlow(renderer, rect, glowColor);
-}
-
-void Game::renderParticles() {
-    static std::vector<SDL_Point> particles;
-    static int frame = 0;
-    
-    // 每隔一段时间添加新粒子
-    if (frame++ % 10 == 0) {
-        SDL_Point particle = {
-            rand() % WINDOW_WIDTH,
-            rand() % WINDOW_HEIGHT
-        };
-        particles.push_back(particle);
-    }
-    
-    // 渲染并更新粒子
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 50);
-    for (auto& p : particles) {
-        SDL_RenderDrawPoint(renderer, p.x, p.y);
-        p.y = (p.y + 1) % WINDOW_HEIGHT;
-    }
-    
-    // 限制粒子数量
-    if (particles.size() > 100) {
-        particles.erase(particles.begin());
-    }
+    Effects::renderGlow(backend, rect, glowColor);
 }
 
 void Game::renderMazeGlow(const SDL_Rect& area) {
     SDL_Color glowColor = {65, 105, 225, 50}; // 蓝色发光效果
-    Effects::renderGlow(renderer, area, glowColor);
-}
-
-void Game::renderPlayerTrail() {
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 100);
-    for (const auto& point : playerTrail) {
-        SDL_RenderDrawPoint(renderer, point.x, point.y);
-    }
+    Effects::renderGlow(backend, area, glowColor);
 }
 
 void Game::renderDynamicLighting() {
@@ -1120,63 +2124,20 @@ void Game::renderDynamicLighting() {
         100,
         100
     };
-    Effects::renderGlow(renderer, lightArea, lightColor);
+    Effects::renderGlow(backend, lightArea, lightColor);
 }
 
 void Game::calculateHintPath() {
     if (!currentMaze || !player) return;
     
-    // 清除旧的提示路径
-    hintPath.clear();
-    
-    // 使用简单的BFS寻路算法
-    std::queue<SDL_Point> queue;
-    std::map<SDL_Point, SDL_Point, PointCompare> cameFrom;
-    SDL_Point start = {player->getX(), player->getY()};  // 从当前位置开始
-    SDL_Point goal;
-    
-    // 找到终点位置
-    for (int y = 0; y < currentMaze->getHeight(); y++) {
-        for (int x = 0; x < currentMaze->getWidth(); x++) {
-            if (currentMaze->isGoal(x, y)) {
-                goal = {x, y};
-                break;
-            }
-        }
-    }
-    
-    queue.push(start);
-    cameFrom[start] = start;
-    
-    // BFS搜索
-    while (!queue.empty()) {
-        SDL_Point current = queue.front();
-        queue.pop();
-        
-        if (current.x == goal.x && current.y == goal.y) {
-            break;
-        }
-        
-        // 检查四个方向
-        const int dx[] = {0, 1, 0, -1};
-        const int dy[] = {-1, 0, 1, 0};
-        
-        for (int i = 0; i < 4; i++) {
-            SDL_Point next = {current.x + dx[i], current.y + dy[i]};
-            if (!currentMaze->isWall(next.x, next.y) && cameFrom.find(next) == cameFrom.end()) {
-                queue.push(next);
-                cameFrom[next] = current;
-            }
-        }
+    // 有距离场时沿距离递减方向直接走到终点，否则退回 BFS
+    if (currentMaze->hasDistanceField()) {
+        currentMaze->traceToGoal(player->getX(), player->getY(), hintPath);
+        return;
     }
     
-    // 重建路径
-    SDL_Point current = goal;
-    while (!(current.x == start.x && current.y == start.y)) {
-        hintPath.push_back(current);
-        current = cameFrom[current];
-    }
-    std::reverse(hintPath.begin(), hintPath.end());
+    SDL_Point start = {player->getX(), player->getY()};
+    pathFinder.findPath(*currentMaze, start, currentMaze->getGoalPosition(), hintPath);
 }
 
 // 私有辅助方法的实现...
@@ -0,0 +1,256 @@
+#include "InputRecorder.h"
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace {
+    // 变长整数：每字节 7 位，最高位表示后面还有字节
+    void writeVarint(std::string& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    // 有符号数先做 zigzag 编码，绝对值小的负数也只占一个字节
+    void writeSigned(std::string& out, int32_t value) {
+        uint32_t zigzag = (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+        writeVarint(out, zigzag);
+    }
+
+    bool readVarint(const std::string& in, size_t& pos, uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && pos < in.size(); shift += 7) {
+            uint8_t byte = static_cast<uint8_t>(in[pos++]);
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+
+    bool readSigned(const std::string& in, size_t& pos, int32_t& value) {
+        uint64_t zigzag;
+        if (!readVarint(in, pos, zigzag)) return false;
+        uint32_t bits = static_cast<uint32_t>(zigzag);
+        value = static_cast<int32_t>((bits >> 1) ^ (~(bits & 1) + 1));
+        return true;
+    }
+}
+
+int InputRecorder::fieldCount(uint8_t type) {
+    switch (static_cast<RecordType>(type)) {
+        case RecordType::KEY_DOWN:
+        case RecordType::KEY_UP:
+        case RecordType::MOUSE_DOWN:
+        case RecordType::MOUSE_UP:
+        case RecordType::MOUSE_MOTION:
+            return 3;
+        case RecordType::MOUSE_WHEEL:
+            return 2;
+        case RecordType::QUIT:
+            return 0;
+        default:
+            return -1;
+    }
+}
+
+bool InputRecorder::isRecordable(const SDL_Event& event) {
+    switch (event.type) {
+        case SDL_KEYDOWN:
+        case SDL_KEYUP:
+        case SDL_MOUSEBUTTONDOWN:
+        case SDL_MOUSEBUTTONUP:
+        case SDL_MOUSEMOTION:
+        case SDL_MOUSEWHEEL:
+        case SDL_QUIT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void InputRecorder::recordEvent(uint64_t step, const SDL_Event& event) {
+    Record record = {step, RecordType::QUIT, 0, 0, 0};
+    switch (event.type) {
+        case SDL_KEYDOWN:
+        case SDL_KEYUP:
+            record.type = event.type == SDL_KEYDOWN ? RecordType::KEY_DOWN : RecordType::KEY_UP;
+            record.a = event.key.keysym.sym;
+            record.b = event.key.keysym.mod;
+            record.c = event.key.repeat;
+            break;
+        case SDL_MOUSEBUTTONDOWN:
+        case SDL_MOUSEBUTTONUP:
+            record.type = event.type == SDL_MOUSEBUTTONDOWN ? RecordType::MOUSE_DOWN : RecordType::MOUSE_UP;
+            record.a = event.button.button;
+            record.b = event.button.x;
+            record.c = event.button.y;
+            break;
+        case SDL_MOUSEMOTION:
+            record.type = RecordType::MOUSE_MOTION;
+            record.a = event.motion.x;
+            record.b = event.motion.y;
+            record.c = static_cast<int32_t>(event.motion.state);
+            break;
+        case SDL_MOUSEWHEEL:
+            record.type = RecordType::MOUSE_WHEEL;
+            record.a = event.wheel.x;
+            record.b = event.wheel.y;
+            break;
+        case SDL_QUIT:
+            break;
+        default:
+            return;
+    }
+    events.push_back(record);
+}
+
+void InputRecorder::recordSeed(uint64_t step, uint32_t seed) {
+    seeds.push_back({step, seed});
+}
+
+bool InputRecorder::save(const std::string& path) const {
+    // 头部（标识、版本、起始进度）之后按步数顺序交错写出事件和种子，步数只存与上一条的差值
+    std::string data(MAGIC, sizeof(MAGIC));
+    data.push_back(static_cast<char>(VERSION));
+    writeVarint(data, static_cast<uint64_t>(startUnlockedLevel));
+
+    uint64_t previousStep = 0;
+    size_t e = 0;
+    size_t s = 0;
+    while (e < events.size() || s < seeds.size()) {
+        bool takeEvent = s >= seeds.size() ||
+                         (e < events.size() && events[e].step <= seeds[s].step);
+        if (takeEvent) {
+            const Record& record = events[e++];
+            writeVarint(data, record.step - previousStep);
+            previousStep = record.step;
+            data.push_back(static_cast<char>(record.type));
+            int fields = fieldCount(static_cast<uint8_t>(record.type));
+            if (fields > 0) writeSigned(data, record.a);
+            if (fields > 1) writeSigned(data, record.b);
+            if (fields > 2) writeSigned(data, record.c);
+        } else {
+            const Seed& seed = seeds[s++];
+            writeVarint(data, seed.step - previousStep);
+            previousStep = seed.step;
+            data.push_back(static_cast<char>(RecordType::SEED));
+            writeVarint(data, seed.value);
+        }
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Cannot write input recording: " << path << std::endl;
+        return false;
+    }
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    return file.good();
+}
+
+bool InputRecorder::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Cannot open input recording: " << path << std::endl;
+        return false;
+    }
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (data.size() < sizeof(MAGIC) + 1 || data.compare(0, sizeof(MAGIC), MAGIC, sizeof(MAGIC)) != 0 ||
+        static_cast<uint8_t>(data[sizeof(MAGIC)]) != VERSION) {
+        std::cerr << "Not a supported input recording: " << path << std::endl;
+        return false;
+    }
+
+    events.clear();
+    seeds.clear();
+    eventCursor = 0;
+    seedCursor = 0;
+
+    size_t pos = sizeof(MAGIC) + 1;
+    uint64_t unlocked;
+    if (!readVarint(data, pos, unlocked)) {
+        std::cerr << "Input recording header is truncated: " << path << std::endl;
+        return false;
+    }
+    startUnlockedLevel = static_cast<int>(unlocked);
+    
+    uint64_t step = 0;
+    while (pos < data.size()) {
+        uint64_t delta;
+        if (!readVarint(data, pos, delta) || pos >= data.size()) break;
+        step += delta;
+        uint8_t type = static_cast<uint8_t>(data[pos++]);
+
+        if (type == static_cast<uint8_t>(RecordType::SEED)) {
+            uint64_t value;
+            if (!readVarint(data, pos, value)) break;
+            seeds.push_back({step, static_cast<uint32_t>(value)});
+            continue;
+        }
+
+        int fields = fieldCount(type);
+        if (fields < 0) break;
+        Record record = {step, static_cast<RecordType>(type), 0, 0, 0};
+        if ((fields > 0 && !readSigned(data, pos, record.a)) ||
+            (fields > 1 && !readSigned(data, pos, record.b)) ||
+            (fields > 2 && !readSigned(data, pos, record.c))) {
+            break;
+        }
+        events.push_back(record);
+    }
+
+    if (pos < data.size()) {
+        std::cerr << "Input recording is truncated or corrupt: " << path << std::endl;
+    }
+    return true;
+}
+
+bool InputRecorder::nextEvent(uint64_t step, SDL_Event& event) {
+    if (eventCursor >= events.size() || events[eventCursor].step > step) return false;
+
+    const Record& record = events[eventCursor++];
+    event = SDL_Event();
+    switch (record.type) {
+        case RecordType::KEY_DOWN:
+        case RecordType::KEY_UP:
+            event.type = record.type == RecordType::KEY_DOWN ? SDL_KEYDOWN : SDL_KEYUP;
+            event.key.state = record.type == RecordType::KEY_DOWN ? SDL_PRESSED : SDL_RELEASED;
+            event.key.keysym.sym = record.a;
+            event.key.keysym.scancode = SDL_GetScancodeFromKey(record.a);
+            event.key.keysym.mod = static_cast<Uint16>(record.b);
+            event.key.repeat = static_cast<Uint8>(record.c);
+            break;
+        case RecordType::MOUSE_DOWN:
+        case RecordType::MOUSE_UP:
+            event.type = record.type == RecordType::MOUSE_DOWN ? SDL_MOUSEBUTTONDOWN : SDL_MOUSEBUTTONUP;
+            event.button.state = record.type == RecordType::MOUSE_DOWN ? SDL_PRESSED : SDL_RELEASED;
+            event.button.button = static_cast<Uint8>(record.a);
+            event.button.clicks = 1;
+            event.button.x = record.b;
+            event.button.y = record.c;
+            break;
+        case RecordType::MOUSE_MOTION:
+            event.type = SDL_MOUSEMOTION;
+            event.motion.x = record.a;
+            event.motion.y = record.b;
+            event.motion.state = static_cast<Uint32>(record.c);
+            break;
+        case RecordType::MOUSE_WHEEL:
+            event.type = SDL_MOUSEWHEEL;
+            event.wheel.x = record.a;
+            event.wheel.y = record.b;
+            break;
+        default:
+            event.type = SDL_QUIT;
+            break;
+    }
+    return true;
+}
+
+bool InputRecorder::nextSeed(uint32_t& seed) {
+    if (seedCursor >= seeds.size()) return false;
+    seed = seeds[seedCursor++].value;
+    return true;
+}
@@ -1,208 +1,342 @@
 #include "Maze.h"
+#include "RingQueue.h"
 #include <fstream>
 #include <random>
-#include <stack>
 #include <iostream>
 
-Maze::Maze() : width(0), height(0) {
-    // 初始化 mazeData 为一个有效的空迷宫
-    mazeData = std::vector<std::vector<int>>(1, std::vector<int>(1, PATH));
-}
+Maze::Maze() : width(0), height(0), stride(2), neighborOffsets{0, 0, 0, 0},
+               goalPosition{-1, -1}, seed(0), distanceFieldValid(false) {}
 
 Maze::~Maze() {}
 
 bool Maze::loadLevel(int level) {
     std::string filename = "levels/level" + std::to_string(level) + ".txt";
-    std::ifstream file(filename);
+    return loadFromFile(filename);
+}
+
+void Maze::generateRandomMaze(int size, MazeAlgorithm algorithm) {
+    // 种子发生器只初始化一次，每次生成都记录所用的种子以便复现
+    static std::mt19937 seeder(std::random_device{}());
+    generateRandomMaze(size, algorithm, seeder());
+}
+
+void Maze::generateRandomMaze(int size, MazeAlgorithm algorithm, uint32_t newSeed) {
+    // 至少需要一个房间加一圈外墙
+    if (size < 3) size = 3;
     
-    if (!file.is_open()) {
-        std::cerr << "Cannot open level file: " << filename << std::endl;
-        return false;
-    }
+    // 初始化迷宫为全墙，由生成器直接在位图上打通通道
+    resetGrid(size, size, true);
+    seed = newSeed;
+    std::mt19937 rng(seed);
+    MazeGenerator::create(algorithm)->generate(*this, rng);
     
-    std::vector<std::string> lines;
-    std::string line;
+    // 起点是第一个房间，终点放在最后一个房间（偶数尺寸时也保证可达）
+    int lastRoom = ((size - 1) / 2) * 2 - 1;
+    setWall(1, 1, false);
+    goalPosition = {lastRoom, lastRoom};
+    setWall(goalPosition.x, goalPosition.y, false);
     
-    // 读取所有行
-    while (std::getline(file, line)) {
-        if (!line.empty()) {
-            lines.push_back(line);
+    rebuildOpenMasks();
+}
+
+void Maze::generateEndlessWindow(int newWidth, int windowHeight, EllerMazeStream& stream) {
+    if (newWidth < 3) newWidth = 3;
+    if (windowHeight < 3) windowHeight = 3;
+    
+    // 无尽模式没有终点
+    resetGrid(newWidth, windowHeight, true);
+    stream.generate(*this);
+    rebuildOpenMasks();
+}
+
+void Maze::scrollUp(int cellRows) {
+    // 窗口很小，逐格搬移即可；移出的行直接丢弃，底部补成墙
+    for (int y = 0; y < height; y++) {
+        int source = y + cellRows;
+        for (int x = 0; x < width; x++) {
+            setWall(x, y, source < height ? testWall(cellIndex(x, source)) : true);
         }
     }
+    distanceFieldValid = false;
+}
+
+void Maze::resetGrid(int newWidth, int newHeight, bool fillWall) {
+    width = newWidth;
+    height = newHeight;
+    stride = width + 2;
+    neighborOffsets[DIR_UP] = -stride;
+    neighborOffsets[DIR_RIGHT] = 1;
+    neighborOffsets[DIR_DOWN] = stride;
+    neighborOffsets[DIR_LEFT] = -1;
+    goalPosition = {-1, -1};
+    distanceCodes.clear();
+    distanceFieldValid = false;
     
-    if (lines.empty()) {
-        std::cerr << "Level file is empty: " << filename << std::endl;
-        return false;
-    }
+    size_t cellCount = static_cast<size_t>(getCellCount());
+    wallBits.assign((cellCount + 63) / 64, fillWall ? ~uint64_t(0) : uint64_t(0));
+    openMasks.assign((cellCount + 1) / 2, 0);
     
-    try {
-        // 设置迷宫尺寸
-        height = lines.size();
-        width = lines[0].length();
-        
-        // 初始化迷宫数据
-        mazeData.clear();
-        mazeData.resize(height, std::vector<int>(width));
-        
-        // 解析迷宫数据
+    // 哨兵边框始终是墙
+    if (!fillWall) {
+        for (int x = -1; x <= width; x++) {
+            setWall(x, -1, true);
+            setWall(x, height, true);
+        }
         for (int y = 0; y < height; y++) {
-            if (lines[y].length() != width) {
-                std::cerr << "Invalid maze format: inconsistent width at line " << y << std::endl;
-                return false;
-            }
-            
-            for (int x = 0; x < width; x++) {
-                char c = lines[y][x];
-                switch (c) {
-                    case '#':
-                        mazeData[y][x] = WALL;
-                        break;
-                    case '.':
-                    case 'P': // 玩家起点也是路径
-                        mazeData[y][x] = PATH;
-                        break;
-                    case 'G':
-                        mazeData[y][x] = GOAL;
-                        goalPosition = {x, y};
-                        break;
-                    default:
-                        mazeData[y][x] = PATH;
-                        break;
-                }
-            }
+            setWall(-1, y, true);
+            setWall(width, y, true);
+        }
+    }
+}
+
+uint8_t Maze::computeOpenMask(int index) const {
+    if (isWallAt(index)) return 0;
+    
+    uint8_t mask = 0;
+    for (int dir = 0; dir < 4; dir++) {
+        mask |= static_cast<uint8_t>(!isWallAt(index + neighborOffsets[dir])) << dir;
+    }
+    return mask;
+}
+
+void Maze::storeOpenMask(int index, uint8_t mask) {
+    int shift = (index & 1) << 2;
+    uint8_t& packed = openMasks[index >> 1];
+    packed = static_cast<uint8_t>((packed & ~(0x0F << shift)) | (mask << shift));
+}
+
+void Maze::rebuildOpenMasks() {
+    for (int y = 0; y < height; y++) {
+        int index = toIndex(0, y);
+        for (int x = 0; x < width; x++, index++) {
+            storeOpenMask(index, computeOpenMask(index));
         }
-        
-        return true;
-    } catch (const std::exception& e) {
-        std::cerr << "Error loading level: " << e.what() << std::endl;
-        return false;
     }
 }
 
-void Maze::generateRandomMaze(int size) {
-    width = height = size;
-    // 初始化迷宫为全墙
-    mazeData = std::vector<std::vector<int>>(size, std::vector<int>(size, WALL));
+void Maze::setCell(int x, int y, int type) {
+    if (!isValidPosition(x, y)) return;
     
-    // 使用DFS生成迷宫
-    generateMazeUsingDFS(size);
+    setWall(x, y, type == WALL);
+    if (type == GOAL) {
+        goalPosition = {x, y};
+    } else if (isGoal(x, y)) {
+        goalPosition = {-1, -1};
+    }
+    
+    // 连通性变化后距离场需要重新构建
+    distanceFieldValid = false;
     
-    // 设置起点和终点
-    mazeData[1][1] = PATH;  // 起点
-    goalPosition = {size - 2, size - 2};
-    mazeData[goalPosition.y][goalPosition.x] = GOAL;
+    // 只有该格和四个邻居的掩码会受影响；哨兵格的掩码恒为 0
+    int index = toIndex(x, y);
+    storeOpenMask(index, computeOpenMask(index));
+    for (int dir = 0; dir < 4; dir++) {
+        int neighbor = index + neighborOffsets[dir];
+        int nx = x + DIRECTION_DX[dir];
+        int ny = y + DIRECTION_DY[dir];
+        if (isValidPosition(nx, ny)) {
+            storeOpenMask(neighbor, computeOpenMask(neighbor));
+        }
+    }
+}
+
+size_t Maze::countOpenCells() const {
+    size_t openCells = 0;
+    for (int y = 0; y < height; y++) {
+        int index = toIndex(0, y);
+        for (int x = 0; x < width; x++, index++) {
+            openCells += !isWallAt(index);
+        }
+    }
+    return openCells;
 }
 
-void Maze::generateMazeUsingDFS(int size) {
-    std::stack<SDL_Point> stack;
-    std::random_device rd;
-    std::mt19937 gen(rd());
+void Maze::storeDistanceCode(int index, uint8_t code) {
+    int shift = (index & 3) << 1;
+    uint8_t& packed = distanceCodes[index >> 2];
+    packed = static_cast<uint8_t>((packed & ~(3 << shift)) | (code << shift));
+}
+
+void Maze::buildDistanceField() {
+    // 全部初始化为不可达（每格两位都置 1）
+    distanceCodes.assign((static_cast<size_t>(getCellCount()) + 3) / 4, 0xFF);
+    distanceFieldValid = true;
     
-    // 从(1,1)开始生成
-    stack.push({1, 1});
-    mazeData[1][1] = PATH;
+    if (isWall(goalPosition.x, goalPosition.y)) {
+        return;
+    }
     
-    while (!stack.empty()) {
-        SDL_Point current = stack.top();
-        
-        // 可能的移动方向：上、右、下、左
-        std::vector<SDL_Point> directions = {
-            {0, -2}, {2, 0}, {0, 2}, {-2, 0}
-        };
-        
-        // 随机打乱方向
-        std::shuffle(directions.begin(), directions.end(), gen);
-        
-        bool foundPath = false;
-        for (const auto& dir : directions) {
-            int newX = current.x + dir.x;
-            int newY = current.y + dir.y;
-            
-            if (newX > 0 && newX < size - 1 && newY > 0 && newY < size - 1 
-                && mazeData[newY][newX] == WALL) {
-                // 打通墙壁
-                mazeData[current.y + dir.y/2][current.x + dir.x/2] = PATH;
-                mazeData[newY][newX] = PATH;
-                stack.push({newX, newY});
-                foundPath = true;
-                break;
+    RingQueue<int32_t> queue;
+    queue.reset(countOpenCells());
+    
+    int goalIndex = toIndex(goalPosition.x, goalPosition.y);
+    storeDistanceCode(goalIndex, 0);
+    queue.push(goalIndex);
+    
+    while (!queue.empty()) {
+        int current = queue.pop();
+        uint8_t nextCode = static_cast<uint8_t>((distanceCodeAt(current) + 1) % 3);
+        forEachOpenNeighbor(current, [&](int next, int) {
+            if (distanceCodeAt(next) == UNREACHABLE) {
+                storeDistanceCode(next, nextCode);
+                queue.push(next);
             }
+        });
+    }
+}
+
+int Maze::stepTowardGoal(int index) const {
+    // 距离减 1 等价于模 3 的编码减 1
+    uint8_t wanted = static_cast<uint8_t>((distanceCodeAt(index) + 2) % 3);
+    unsigned mask = openDirectionsAt(index);
+    while (mask) {
+        int next = index + neighborOffsets[std::countr_zero(mask)];
+        if (distanceCodeAt(next) == wanted) return next;
+        mask &= mask - 1;
+    }
+    return -1;
+}
+
+bool Maze::traceToGoal(int x, int y, std::vector<SDL_Point>& path) const {
+    path.clear();
+    if (!distanceFieldValid || isWall(x, y)) return false;
+    
+    int index = toIndex(x, y);
+    if (distanceCodeAt(index) == UNREACHABLE) return false;
+    
+    int goalIndex = toIndex(goalPosition.x, goalPosition.y);
+    while (index != goalIndex) {
+        index = stepTowardGoal(index);
+        if (index < 0) {
+            path.clear();
+            return false;
         }
-        
-        if (!foundPath) {
-            stack.pop();
-        }
+        path.push_back({indexToX(index), indexToY(index)});
     }
+    return true;
 }
 
-void Maze::render(SDL_Renderer* renderer) {
+int Maze::getDistanceToGoal(int x, int y) const {
+    if (!distanceFieldValid || isWall(x, y)) return -1;
+    
+    int index = toIndex(x, y);
+    if (distanceCodeAt(index) == UNREACHABLE) return -1;
+    
+    int goalIndex = toIndex(goalPosition.x, goalPosition.y);
+    int steps = 0;
+    for (; index != goalIndex; steps++) {
+        index = stepTowardGoal(index);
+        if (index < 0) return -1;
+    }
+    return steps;
+}
+
+int Maze::directionFromDelta(int dx, int dy) {
+    for (int dir = 0; dir < 4; dir++) {
+        if (DIRECTION_DX[dir] == dx && DIRECTION_DY[dir] == dy) return dir;
+    }
+    return -1;
+}
+
+void Maze::setWall(int x, int y, bool wall) {
+    size_t index = cellIndex(x, y);
+    uint64_t mask = uint64_t(1) << (index & 63);
+    if (wall) {
+        wallBits[index >> 6] |= mask;
+    } else {
+        wallBits[index >> 6] &= ~mask;
+    }
+}
+
+void Maze::render(RenderBackend* renderer) {
     const int CELL_SIZE = 30;  // 每个格子的大小
     
     for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
+        int index = toIndex(0, y);
+        for (int x = 0; x < width; ++x, ++index) {
             SDL_Rect rect = {x * CELL_SIZE, y * CELL_SIZE, CELL_SIZE, CELL_SIZE};
             
-            switch (mazeData[y][x]) {
-                case WALL:
-                    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);  // 黑色墙壁
-                    break;
-                case PATH:
-                    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);  // 白色路径
-                    break;
-                case GOAL:
-                    SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);  // 绿色终点
-                    break;
+            if (isWallAt(index)) {
+                renderer->setDrawColor(0, 0, 0, 255);  // 黑色墙壁
+            } else if (isGoal(x, y)) {
+                renderer->setDrawColor(0, 255, 0, 255);  // 绿色终点
+            } else {
+                renderer->setDrawColor(255, 255, 255, 255);  // 白色路径
             }
             
-            SDL_RenderFillRect(renderer, &rect);
+            renderer->fillRect(&rect);
         }
     }
 }
 
 bool Maze::isWall(int x, int y) const {
     if (!isValidPosition(x, y)) return true;
-    return mazeData[y][x] == WALL;
+    return testWall(cellIndex(x, y));
 }
 
 bool Maze::isGoal(int x, int y) const {
-    if (!isValidPosition(x, y)) return false;
-    return mazeData[y][x] == GOAL;
+    return x == goalPosition.x && y == goalPosition.y;
 }
 
 bool Maze::isValidPosition(int x, int y) const {
-    return x >= 0 && x < width && y >= 0 && y < height && !mazeData.empty() && !mazeData[0].empty();
+    // 无符号比较同时排除负坐标
+    return static_cast<unsigned>(x) < static_cast<unsigned>(width) &&
+           static_cast<unsigned>(y) < static_cast<unsigned>(height);
 }
 
 bool Maze::loadFromFile(const std::string& filename) {
     std::ifstream file(filename);
+    
     if (!file.is_open()) {
+        std::cerr << "Cannot open level file: " << filename << std::endl;
         return false;
     }
     
-    mazeData.clear();
+    std::vector<std::string> lines;
     std::string line;
+    
+    // 读取所有行
     while (std::getline(file, line)) {
-        std::vector<int> row;
-        for (char c : line) {
-            switch (c) {
-                case '#': row.push_back(WALL); break;
-                case '.': row.push_back(PATH); break;
-                case 'G': 
-                    row.push_back(GOAL);
-                    goalPosition = {static_cast<int>(row.size() - 1), 
-                                  static_cast<int>(mazeData.size())};
-                    break;
-            }
-        }
-        if (!row.empty()) {
-            mazeData.push_back(row);
+        if (!line.empty()) {
+            lines.push_back(line);
         }
     }
     
-    if (!mazeData.empty()) {
-        height = mazeData.size();
-        width = mazeData[0].size();
+    if (lines.empty()) {
+        std::cerr << "Level file is empty: " << filename << std::endl;
+        return false;
     }
     
-    return true;
+    try {
+        // 设置迷宫尺寸并初始化为全通路
+        int lineWidth = static_cast<int>(lines[0].length());
+        resetGrid(lineWidth, static_cast<int>(lines.size()), false);
+        
+        // 解析迷宫数据
+        for (int y = 0; y < height; y++) {
+            if (static_cast<int>(lines[y].length()) != width) {
+                std::cerr << "Invalid maze format: inconsistent width at line " << y << std::endl;
+                return false;
+            }
+            
+            for (int x = 0; x < width; x++) {
+                switch (lines[y][x]) {
+                    case '#':
+                        setWall(x, y, true);
+                        break;
+                    case 'G':
+                        goalPosition = {x, y};
+                        break;
+                    default: // '.' 和玩家起点 'P' 都是路径
+                        break;
+                }
+            }
+        }
+        
+        rebuildOpenMasks();
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Error loading level: " << e.what() << std::endl;
+        return false;
+    }
 }
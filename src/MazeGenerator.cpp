@@ -0,0 +1,491 @@
+#include "MazeGenerator.h"
+#include "Maze.h"
+#include <array>
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+// 四个方向的全部 24 种排列，DFS 每步随机选一种，避免反复构造和打乱方向数组
+const std::array<std::array<uint8_t, 4>, 24>& directionOrders() {
+    static const auto table = [] {
+        std::array<std::array<uint8_t, 4>, 24> orders{};
+        std::array<uint8_t, 4> order = {0, 1, 2, 3};
+        for (auto& entry : orders) {
+            entry = order;
+            std::next_permutation(order.begin(), order.end());
+        }
+        return orders;
+    }();
+    return table;
+}
+
+// 统一用取模得到随机数，保证同一种子在各平台上生成相同的迷宫
+inline uint32_t randomBelow(std::mt19937& rng, uint32_t bound) {
+    return rng() % bound;
+}
+
+class DfsGenerator : public MazeGenerator {
+public:
+    void generate(Maze& maze, std::mt19937& rng) override {
+        int columns = roomColumns(maze);
+        int rows = roomRows(maze);
+        if (columns <= 0 || rows <= 0) return;
+
+        std::vector<int> stack;
+        stack.push_back(0);
+        openRoom(maze, 0, 0);
+
+        const auto& orders = directionOrders();
+        while (!stack.empty()) {
+            int room = stack.back();
+            int roomX = room % columns;
+            int roomY = room / columns;
+
+            const auto& order = orders[randomBelow(rng, 24)];
+            bool advanced = false;
+            for (uint8_t dir : order) {
+                int nextX = roomX + Maze::DIRECTION_DX[dir];
+                int nextY = roomY + Maze::DIRECTION_DY[dir];
+                if (nextX >= 0 && nextX < columns && nextY >= 0 && nextY < rows &&
+                    !isRoomOpen(maze, nextX, nextY)) {
+                    setPassage(maze, roomX, roomY, dir, true);
+                    openRoom(maze, nextX, nextY);
+                    stack.push_back(nextY * columns + nextX);
+                    advanced = true;
+                    break;
+                }
+            }
+
+            if (!advanced) {
+                stack.pop_back();
+            }
+        }
+    }
+};
+
+class KruskalGenerator : public MazeGenerator {
+public:
+    void generate(Maze& maze, std::mt19937& rng) override {
+        int columns = roomColumns(maze);
+        int rows = roomRows(maze);
+        if (columns <= 0 || rows <= 0) return;
+
+        int roomCount = columns * rows;
+
+        // 边编号：房间编号 * 2 + (0 = 向右, 1 = 向下)
+        std::vector<uint32_t> edges;
+        edges.reserve(static_cast<size_t>(roomCount) * 2);
+        for (int y = 0; y < rows; y++) {
+            for (int x = 0; x < columns; x++) {
+                uint32_t room = static_cast<uint32_t>(y * columns + x);
+                openRoom(maze, x, y);
+                if (x + 1 < columns) edges.push_back(room << 1);
+                if (y + 1 < rows) edges.push_back((room << 1) | 1u);
+            }
+        }
+        for (size_t i = edges.size(); i > 1; i--) {
+            std::swap(edges[i - 1], edges[randomBelow(rng, static_cast<uint32_t>(i))]);
+        }
+
+        parent.resize(roomCount);
+        std::iota(parent.begin(), parent.end(), 0);
+        rank.assign(roomCount, 0);
+
+        int joined = 0;
+        for (uint32_t edge : edges) {
+            int room = static_cast<int>(edge >> 1);
+            bool down = edge & 1u;
+            int other = down ? room + columns : room + 1;
+            if (unite(room, other)) {
+                setPassage(maze, room % columns, room / columns,
+                           down ? Maze::DIR_DOWN : Maze::DIR_RIGHT, true);
+                if (++joined == roomCount - 1) break;
+            }
+        }
+    }
+
+private:
+    std::vector<int> parent;
+    std::vector<uint8_t> rank;
+
+    int find(int room) {
+        // 路径减半
+        while (parent[room] != room) {
+            parent[room] = parent[parent[room]];
+            room = parent[room];
+        }
+        return room;
+    }
+
+    bool unite(int a, int b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return false;
+        if (rank[a] < rank[b]) std::swap(a, b);
+        parent[b] = a;
+        if (rank[a] == rank[b]) rank[a]++;
+        return true;
+    }
+};
+
+class PrimGenerator : public MazeGenerator {
+public:
+    void generate(Maze& maze, std::mt19937& rng) override {
+        int columns = roomColumns(maze);
+        int rows = roomRows(maze);
+        if (columns <= 0 || rows <= 0) return;
+
+        std::vector<uint8_t> inFrontier(static_cast<size_t>(columns) * rows, 0);
+        std::vector<int> frontier;
+
+        auto addFrontier = [&](int roomX, int roomY) {
+            for (int dir = 0; dir < 4; dir++) {
+                int nextX = roomX + Maze::DIRECTION_DX[dir];
+                int nextY = roomY + Maze::DIRECTION_DY[dir];
+                if (nextX < 0 || nextX >= columns || nextY < 0 || nextY >= rows) continue;
+                int next = nextY * columns + nextX;
+                if (!inFrontier[next] && !isRoomOpen(maze, nextX, nextY)) {
+                    inFrontier[next] = 1;
+                    frontier.push_back(next);
+                }
+            }
+        };
+
+        int start = static_cast<int>(randomBelow(rng, static_cast<uint32_t>(columns * rows)));
+        openRoom(maze, start % columns, start / columns);
+        addFrontier(start % columns, start / columns);
+
+        while (!frontier.empty()) {
+            // 随机取出一个边界房间（与末尾交换后删除）
+            size_t pick = randomBelow(rng, static_cast<uint32_t>(frontier.size()));
+            int room = frontier[pick];
+            frontier[pick] = frontier.back();
+            frontier.pop_back();
+
+            int roomX = room % columns;
+            int roomY = room / columns;
+
+            // 随机连到一个已在迷宫中的邻居
+            int candidates[4];
+            int count = 0;
+            for (int dir = 0; dir < 4; dir++) {
+                int nextX = roomX + Maze::DIRECTION_DX[dir];
+                int nextY = roomY + Maze::DIRECTION_DY[dir];
+                if (nextX >= 0 && nextX < columns && nextY >= 0 && nextY < rows &&
+                    isRoomOpen(maze, nextX, nextY)) {
+                    candidates[count++] = dir;
+                }
+            }
+
+            openRoom(maze, roomX, roomY);
+            setPassage(maze, roomX, roomY, candidates[randomBelow(rng, count)], true);
+            addFrontier(roomX, roomY);
+        }
+    }
+};
+
+class WilsonGenerator : public MazeGenerator {
+public:
+    void generate(Maze& maze, std::mt19937& rng) override {
+        int columns = roomColumns(maze);
+        int rows = roomRows(maze);
+        if (columns <= 0 || rows <= 0) return;
+
+        int roomCount = columns * rows;
+        std::vector<uint8_t> exitDir(roomCount, 0);
+
+        int root = static_cast<int>(randomBelow(rng, static_cast<uint32_t>(roomCount)));
+        openRoom(maze, root % columns, root / columns);
+
+        for (int start = 0; start < roomCount; start++) {
+            if (isRoomOpen(maze, start % columns, start / columns)) continue;
+
+            // 随机游走直到碰到已生成的部分，只记录每个房间最后一次离开的方向，
+            // 这样回放时自然擦除了环
+            int room = start;
+            while (!isRoomOpen(maze, room % columns, room / columns)) {
+                int roomX = room % columns;
+                int roomY = room / columns;
+                int dir;
+                int nextX;
+                int nextY;
+                do {
+                    dir = static_cast<int>(rng() & 3u);
+                    nextX = roomX + Maze::DIRECTION_DX[dir];
+                    nextY = roomY + Maze::DIRECTION_DY[dir];
+                } while (nextX < 0 || nextX >= columns || nextY < 0 || nextY >= rows);
+                exitDir[room] = static_cast<uint8_t>(dir);
+                room = nextY * columns + nextX;
+            }
+
+            // 沿记录的方向把无环路径并入迷宫
+            room = start;
+            while (!isRoomOpen(maze, room % columns, room / columns)) {
+                int roomX = room % columns;
+                int roomY = room / columns;
+                int dir = exitDir[room];
+                openRoom(maze, roomX, roomY);
+                setPassage(maze, roomX, roomY, dir, true);
+                room = (roomY + Maze::DIRECTION_DY[dir]) * columns + roomX + Maze::DIRECTION_DX[dir];
+            }
+        }
+    }
+};
+
+class EllerGenerator : public MazeGenerator {
+public:
+    void generate(Maze& maze, std::mt19937& rng) override {
+        int columns = roomColumns(maze);
+        int rows = roomRows(maze);
+        if (columns <= 0 || rows <= 0) return;
+
+        EllerRowGenerator eller;
+        eller.reset(columns);
+        std::vector<uint8_t> rightOpen;
+        std::vector<uint8_t> downOpen;
+
+        for (int y = 0; y < rows; y++) {
+            eller.nextRow(rng, y == rows - 1, rightOpen, downOpen);
+            for (int x = 0; x < columns; x++) {
+                openRoom(maze, x, y);
+                if (rightOpen[x]) setPassage(maze, x, y, Maze::DIR_RIGHT, true);
+                if (downOpen[x]) setPassage(maze, x, y, Maze::DIR_DOWN, true);
+            }
+        }
+    }
+};
+
+class RecursiveDivisionGenerator : public MazeGenerator {
+public:
+    void generate(Maze& maze, std::mt19937& rng) override {
+        int columns = roomColumns(maze);
+        int rows = roomRows(maze);
+        if (columns <= 0 || rows <= 0) return;
+
+        // 先打通所有房间和通道，再逐步加墙
+        for (int y = 0; y < rows; y++) {
+            for (int x = 0; x < columns; x++) {
+                openRoom(maze, x, y);
+                if (x + 1 < columns) setPassage(maze, x, y, Maze::DIR_RIGHT, true);
+                if (y + 1 < rows) setPassage(maze, x, y, Maze::DIR_DOWN, true);
+            }
+        }
+
+        // 用显式栈代替递归，细长区域也不会栈溢出
+        struct Chamber { int x0, y0, x1, y1; };
+        std::vector<Chamber> stack;
+        stack.push_back({0, 0, columns - 1, rows - 1});
+
+        while (!stack.empty()) {
+            Chamber c = stack.back();
+            stack.pop_back();
+
+            int w = c.x1 - c.x0 + 1;
+            int h = c.y1 - c.y0 + 1;
+            if (w < 2 && h < 2) continue;
+
+            bool horizontal;
+            if (w < 2) horizontal = true;
+            else if (h < 2) horizontal = false;
+            else if (w != h) horizontal = h > w;
+            else horizontal = rng() & 1u;
+
+            if (horizontal) {
+                // 在第 row 行与 row+1 行之间砌墙，留一个缺口
+                int row = c.y0 + static_cast<int>(randomBelow(rng, h - 1));
+                int gap = c.x0 + static_cast<int>(randomBelow(rng, w));
+                for (int x = c.x0; x <= c.x1; x++) {
+                    if (x != gap) setPassage(maze, x, row, Maze::DIR_DOWN, false);
+                }
+                stack.push_back({c.x0, c.y0, c.x1, row});
+                stack.push_back({c.x0, row + 1, c.x1, c.y1});
+            } else {
+                int column = c.x0 + static_cast<int>(randomBelow(rng, w - 1));
+                int gap = c.y0 + static_cast<int>(randomBelow(rng, h));
+                for (int y = c.y0; y <= c.y1; y++) {
+                    if (y != gap) setPassage(maze, column, y, Maze::DIR_RIGHT, false);
+                }
+                stack.push_back({c.x0, c.y0, column, c.y1});
+                stack.push_back({column + 1, c.y0, c.x1, c.y1});
+            }
+        }
+    }
+};
+
+} // namespace
+
+std::unique_ptr<MazeGenerator> MazeGenerator::create(MazeAlgorithm algorithm) {
+    switch (algorithm) {
+        case MazeAlgorithm::KRUSKAL:
+            return std::make_unique<KruskalGenerator>();
+        case MazeAlgorithm::PRIM:
+            return std::make_unique<PrimGenerator>();
+        case MazeAlgorithm::WILSON:
+            return std::make_unique<WilsonGenerator>();
+        case MazeAlgorithm::ELLER:
+            return std::make_unique<EllerGenerator>();
+        case MazeAlgorithm::RECURSIVE_DIVISION:
+            return std::make_unique<RecursiveDivisionGenerator>();
+        case MazeAlgorithm::DFS:
+        default:
+            return std::make_unique<DfsGenerator>();
+    }
+}
+
+int MazeGenerator::roomColumns(const Maze& maze) {
+    return (maze.getWidth() - 1) / 2;
+}
+
+int MazeGenerator::roomRows(const Maze& maze) {
+    return (maze.getHeight() - 1) / 2;
+}
+
+void MazeGenerator::openRoom(Maze& maze, int roomX, int roomY) {
+    maze.setWall(roomX * 2 + 1, roomY * 2 + 1, false);
+}
+
+bool MazeGenerator::isRoomOpen(const Maze& maze, int roomX, int roomY) {
+    return !maze.isWallAt(maze.toIndex(roomX * 2 + 1, roomY * 2 + 1));
+}
+
+void MazeGenerator::setPassage(Maze& maze, int roomX, int roomY, int dir, bool open) {
+    maze.setWall(roomX * 2 + 1 + Maze::DIRECTION_DX[dir],
+                 roomY * 2 + 1 + Maze::DIRECTION_DY[dir], !open);
+}
+
+void MazeGenerator::scrollRows(Maze& maze, int cellRows) {
+    maze.scrollUp(cellRows);
+}
+
+void MazeGenerator::finishEditing(Maze& maze) {
+    maze.rebuildOpenMasks();
+}
+
+void EllerRowGenerator::reset(int newColumns) {
+    columns = newColumns;
+    rowSet.resize(columns);
+    std::iota(rowSet.begin(), rowSet.end(), 0);
+    parent.resize(columns);
+    remap.assign(columns, -1);
+    memberCount.assign(columns, 0);
+    pickedColumn.assign(columns, 0);
+    hasDown.assign(columns, 0);
+}
+
+int EllerRowGenerator::find(int label) {
+    while (parent[label] != label) {
+        parent[label] = parent[parent[label]];
+        label = parent[label];
+    }
+    return label;
+}
+
+void EllerRowGenerator::nextRow(std::mt19937& rng, bool lastRow,
+                                std::vector<uint8_t>& rightOpen,
+                                std::vector<uint8_t>& downOpen) {
+    rightOpen.assign(columns, 0);
+    downOpen.assign(columns, 0);
+
+    // 每行开始时标签都已压缩到 [0, columns)
+    std::iota(parent.begin(), parent.end(), 0);
+
+    // 1. 随机合并相邻且不同集合的房间；最后一行必须全部合并
+    for (int c = 0; c + 1 < columns; c++) {
+        int a = find(rowSet[c]);
+        int b = find(rowSet[c + 1]);
+        if (a != b && (lastRow || (rng() & 1u))) {
+            rightOpen[c] = 1;
+            parent[b] = a;
+        }
+    }
+    if (lastRow) return;
+
+    // 2. 随机向下打通，每个集合至少一个（蓄水池抽样选出保底的列）
+    for (int c = 0; c < columns; c++) {
+        int root = find(rowSet[c]);
+        rowSet[c] = root;
+        memberCount[root] = 0;
+        hasDown[root] = 0;
+    }
+    for (int c = 0; c < columns; c++) {
+        int root = rowSet[c];
+        if (randomBelow(rng, static_cast<uint32_t>(++memberCount[root])) == 0) {
+            pickedColumn[root] = c;
+        }
+        if (rng() & 1u) {
+            downOpen[c] = 1;
+            hasDown[root] = 1;
+        }
+    }
+    for (int c = 0; c < columns; c++) {
+        int root = rowSet[c];
+        if (!hasDown[root]) {
+            downOpen[pickedColumn[root]] = 1;
+            hasDown[root] = 1;
+        }
+    }
+
+    // 3. 下一行：向下连通的列沿用集合，其余列各自新建集合，并压缩标签
+    for (int c = 0; c < columns; c++) {
+        remap[rowSet[c]] = -1;
+    }
+    int next = 0;
+    for (int c = 0; c < columns; c++) {
+        if (downOpen[c] && remap[rowSet[c]] < 0) {
+            remap[rowSet[c]] = next++;
+        }
+    }
+    for (int c = 0; c < columns; c++) {
+        rowSet[c] = downOpen[c] ? remap[rowSet[c]] : next++;
+    }
+}
+
+EllerMazeStream::EllerMazeStream(uint32_t seed) : rng(seed) {}
+
+void EllerMazeStream::emitRow(Maze& maze, int roomY) {
+    // 无尽模式永远不是最后一行，每个集合都会继续向下延伸
+    eller.nextRow(rng, false, rightOpen, downOpen);
+    for (int x = 0; x < eller.getColumns(); x++) {
+        openRoom(maze, x, roomY);
+        if (rightOpen[x]) setPassage(maze, x, roomY, Maze::DIR_RIGHT, true);
+        if (downOpen[x]) setPassage(maze, x, roomY, Maze::DIR_DOWN, true);
+    }
+}
+
+void EllerMazeStream::generate(Maze& maze, std::mt19937&) {
+    int columns = roomColumns(maze);
+    int rows = roomRows(maze);
+    if (columns <= 0 || rows <= 0) return;
+
+    eller.reset(columns);
+    for (int y = 0; y < rows; y++) {
+        emitRow(maze, y);
+    }
+}
+
+int EllerMazeStream::advance(Maze& maze, int count) {
+    int columns = roomColumns(maze);
+    int rows = roomRows(maze);
+    if (columns <= 0 || rows <= 0 || count <= 0) return 0;
+    if (count > rows) count = rows;
+
+    // 上移后原最底下的墙线（含通往新行的缺口）落在新行的正上方
+    int cellRows = count * 2;
+    scrollRows(maze, cellRows);
+    for (int y = rows - count; y < rows; y++) {
+        emitRow(maze, y);
+    }
+
+    // 被丢弃的行里可能有连接窗口内两部分的路径。把窗口顶端的房间行全部横向打通，
+    // 任何曾经绕出窗口的路径都能由这条走廊替代，玩家不会被困住
+    for (int x = 0; x + 1 < columns; x++) {
+        setPassage(maze, x, 0, Maze::DIR_RIGHT, true);
+    }
+    for (int x = 0; x < columns; x++) {
+        setPassage(maze, x, 0, Maze::DIR_UP, false);
+    }
+
+    finishEditing(maze);
+    return cellRows;
+}
@@ -0,0 +1,160 @@
+#include "MazePregenerator.h"
+#include <algorithm>
+#include <chrono>
+
+MazePregenerator::MazePregenerator(size_t depth) :
+    running(false),
+    targetDepth(depth),
+    seeder(std::random_device{}()),
+    lastLatencyMs(0.0),
+    totalLatencyMs(0.0),
+    generatedCount(0),
+    hitCount(0),
+    missCount(0)
+{}
+
+MazePregenerator::~MazePregenerator() {
+    stop();
+}
+
+void MazePregenerator::start() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (running) return;
+    running = true;
+    worker = std::thread(&MazePregenerator::workerLoop, this);
+}
+
+void MazePregenerator::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) return;
+        running = false;
+    }
+    wake.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void MazePregenerator::setUpcomingSizes(const std::vector<int>& sizes) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        upcomingSizes = sizes;
+        
+        // 丢弃不再需要的尺寸
+        for (auto it = readyMazes.begin(); it != readyMazes.end(); ) {
+            if (std::find(sizes.begin(), sizes.end(), it->first) == sizes.end()) {
+                it = readyMazes.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    wake.notify_one();
+}
+
+std::unique_ptr<Maze> MazePregenerator::take(int size) {
+    std::unique_ptr<Maze> maze;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = readyMazes.find(size);
+        if (it != readyMazes.end() && !it->second.empty()) {
+            maze = std::move(it->second.front());
+            it->second.pop_front();
+            hitCount++;
+        } else {
+            missCount++;
+        }
+    }
+    // 取走一个后让工作线程补货
+    wake.notify_one();
+    return maze;
+}
+
+int MazePregenerator::pickSizeToGenerate() const {
+    // 按声明顺序优先补齐最近要用的尺寸
+    for (int size : upcomingSizes) {
+        auto it = readyMazes.find(size);
+        size_t depth = it == readyMazes.end() ? 0 : it->second.size();
+        if (depth < targetDepth) return size;
+    }
+    return -1;
+}
+
+void MazePregenerator::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (running) {
+        int size = pickSizeToGenerate();
+        if (size < 0) {
+            wake.wait(lock);
+            continue;
+        }
+        uint32_t seed = seeder();
+        lock.unlock();
+        
+        // 生成和距离场计算都在锁外进行
+        auto begin = std::chrono::steady_clock::now();
+        auto maze = std::make_unique<Maze>();
+        maze->generateRandomMaze(size, MazeAlgorithm::DFS, seed);
+        maze->buildDistanceField();
+        double latency = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - begin).count();
+        
+        lock.lock();
+        lastLatencyMs = latency;
+        totalLatencyMs += latency;
+        generatedCount++;
+        // 生成期间尺寸可能已被撤销
+        if (std::find(upcomingSizes.begin(), upcomingSizes.end(), size) != upcomingSizes.end()) {
+            readyMazes[size].push_back(std::move(maze));
+        }
+    }
+}
+
+void MazePregenerator::setTargetDepth(size_t depth) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        targetDepth = depth;
+    }
+    wake.notify_one();
+}
+
+size_t MazePregenerator::getTargetDepth() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return targetDepth;
+}
+
+size_t MazePregenerator::getQueueDepth() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t total = 0;
+    for (const auto& entry : readyMazes) {
+        total += entry.second.size();
+    }
+    return total;
+}
+
+size_t MazePregenerator::getQueueDepth(int size) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = readyMazes.find(size);
+    return it == readyMazes.end() ? 0 : it->second.size();
+}
+
+double MazePregenerator::getLastLatencyMs() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return lastLatencyMs;
+}
+
+double MazePregenerator::getAverageLatencyMs() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return generatedCount ? totalLatencyMs / generatedCount : 0.0;
+}
+
+size_t MazePregenerator::getHitCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hitCount;
+}
+
+size_t MazePregenerator::getMissCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return missCount;
+}
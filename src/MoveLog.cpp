@@ -0,0 +1,41 @@
+#include "MoveLog.h"
+#include <istream>
+#include <ostream>
+
+void MoveLog::push(Maze::Direction direction) {
+    size_t shift = (count & 3) * 2;
+    if (shift == 0) {
+        bytes.push_back(0);
+    }
+    bytes.back() |= static_cast<uint8_t>(static_cast<uint8_t>(direction) << shift);
+    count++;
+}
+
+Maze::Direction MoveLog::at(size_t index) const {
+    return static_cast<Maze::Direction>((bytes[index >> 2] >> ((index & 3) * 2)) & 3);
+}
+
+void MoveLog::clear() {
+    bytes.clear();
+    count = 0;
+}
+
+void MoveLog::write(std::ostream& out) const {
+    uint32_t moves = static_cast<uint32_t>(count);
+    out.write(reinterpret_cast<const char*>(&moves), sizeof(moves));
+    out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+bool MoveLog::read(std::istream& in) {
+    uint32_t moves = 0;
+    if (!in.read(reinterpret_cast<char*>(&moves), sizeof(moves)) || moves > MAX_MOVES) {
+        return false;
+    }
+    std::vector<uint8_t> packed((moves + 3) / 4);
+    if (!in.read(reinterpret_cast<char*>(packed.data()), static_cast<std::streamsize>(packed.size()))) {
+        return false;
+    }
+    bytes.swap(packed);
+    count = moves;
+    return true;
+}
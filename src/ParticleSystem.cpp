@@ -0,0 +1,93 @@
+#include "ParticleSystem.h"
+
+ParticleSystem::ParticleSystem(size_t capacity) :
+    maxCount(capacity),
+    posX(capacity), posY(capacity),
+    velX(capacity), velY(capacity),
+    life(capacity), decay(capacity),
+    vertices(capacity * 4),
+    indices(capacity * 6) {
+    // 每个粒子两个三角形，索引固定不变
+    for (size_t i = 0; i < capacity; i++) {
+        int base = static_cast<int>(i * 4);
+        int* quad = &indices[i * 6];
+        quad[0] = base;
+        quad[1] = base + 1;
+        quad[2] = base + 2;
+        quad[3] = base;
+        quad[4] = base + 2;
+        quad[5] = base + 3;
+    }
+}
+
+bool ParticleSystem::spawn(float x, float y, float vx, float vy, float lifetime) {
+    if (count >= maxCount || lifetime <= 0.0f) return false;
+    posX[count] = x;
+    posY[count] = y;
+    velX[count] = vx;
+    velY[count] = vy;
+    life[count] = 1.0f;
+    decay[count] = 1.0f / lifetime;
+    count++;
+    return true;
+}
+
+void ParticleSystem::update(float deltaTime) {
+    // 各属性分开遍历，循环体没有分支，编译器可以直接向量化
+    float* __restrict px = posX.data();
+    float* __restrict py = posY.data();
+    const float* __restrict vx = velX.data();
+    const float* __restrict vy = velY.data();
+    float* __restrict l = life.data();
+    const float* __restrict d = decay.data();
+    const size_t n = count;
+
+    for (size_t i = 0; i < n; i++) {
+        px[i] += vx[i] * deltaTime;
+        py[i] += vy[i] * deltaTime;
+    }
+    for (size_t i = 0; i < n; i++) {
+        l[i] -= d[i] * deltaTime;
+    }
+
+    removeDead();
+}
+
+void ParticleSystem::removeDead() {
+    // 用最后一个粒子覆盖死亡粒子，O(1) 删除
+    size_t i = 0;
+    while (i < count) {
+        if (life[i] > 0.0f) {
+            i++;
+            continue;
+        }
+        size_t last = --count;
+        posX[i] = posX[last];
+        posY[i] = posY[last];
+        velX[i] = velX[last];
+        velY[i] = velY[last];
+        life[i] = life[last];
+        decay[i] = decay[last];
+    }
+}
+
+void ParticleSystem::render(RenderBackend* renderer, SDL_Color color) {
+    if (count == 0) return;
+
+    SDL_Vertex* v = vertices.data();
+    for (size_t i = 0; i < count; i++, v += 4) {
+        SDL_Color c = {color.r, color.g, color.b, static_cast<Uint8>(color.a * life[i])};
+        float x0 = posX[i];
+        float y0 = posY[i];
+        float x1 = x0 + 1.0f;
+        float y1 = y0 + 1.0f;
+        v[0] = {{x0, y0}, c, {0.0f, 0.0f}};
+        v[1] = {{x1, y0}, c, {0.0f, 0.0f}};
+        v[2] = {{x1, y1}, c, {0.0f, 0.0f}};
+        v[3] = {{x0, y1}, c, {0.0f, 0.0f}};
+    }
+
+    renderer->setDrawBlendMode(SDL_BLENDMODE_BLEND);
+    renderer->geometry(nullptr, vertices.data(), static_cast<int>(count * 4),
+                       indices.data(), static_cast<int>(count * 6));
+}
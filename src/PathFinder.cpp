@@ -0,0 +1,65 @@
+#include "PathFinder.h"
+#include <algorithm>
+
+void PathFinder::reset(const Maze& maze) {
+    size_t cellCount = static_cast<size_t>(maze.getCellCount());
+    if (visitInfo.size() != cellCount) {
+        visitInfo.assign(cellCount, 0);
+        currentStamp = 0;
+    }
+    
+    // 每个格子最多入队一次，容量取格子总数即可保证不溢出；
+    // 缓冲区不做初始化，未用到的部分不会占用物理内存
+    queue.reset(cellCount);
+}
+
+bool PathFinder::findPath(const Maze& maze, SDL_Point start, SDL_Point goal,
+                          std::vector<SDL_Point>& path) {
+    path.clear();
+    
+    if (maze.isWall(start.x, start.y) || maze.isWall(goal.x, goal.y)) {
+        return false;
+    }
+    if (visitInfo.size() != static_cast<size_t>(maze.getCellCount())) {
+        reset(maze);
+    }
+    
+    // 轮次回绕时才真正清空访问标记
+    if (++currentStamp > MAX_STAMP) {
+        std::fill(visitInfo.begin(), visitInfo.end(), 0);
+        currentStamp = 1;
+    }
+    const uint8_t stampBits = static_cast<uint8_t>(currentStamp << 2);
+    
+    int startIndex = maze.toIndex(start.x, start.y);
+    int goalIndex = maze.toIndex(goal.x, goal.y);
+    
+    queue.clear();
+    visitInfo[startIndex] = stampBits;
+    queue.push(startIndex);
+    
+    bool found = startIndex == goalIndex;
+    while (!found && !queue.empty()) {
+        int current = queue.pop();
+        maze.forEachOpenNeighbor(current, [&](int next, int dir) {
+            if ((visitInfo[next] & ~3u) != stampBits) {
+                visitInfo[next] = static_cast<uint8_t>(stampBits | dir);
+                found = found || next == goalIndex;
+                queue.push(next);
+            }
+        });
+    }
+    
+    if (!found) {
+        return false;
+    }
+    
+    // 从终点沿进入方向反向回溯
+    for (int index = goalIndex; index != startIndex; ) {
+        path.push_back({maze.indexToX(index), maze.indexToY(index)});
+        int dir = visitInfo[index] & 3;
+        index = maze.neighborIndex(index, (dir + 2) & 3);
+    }
+    std::reverse(path.begin(), path.end());
+    return true;
+}
@@ -20,7 +20,7 @@ void Player::handleInput(const SDL_Event& event) {
     }
 }
 
-void Player::render(SDL_Renderer* renderer) {
+void Player::render(RenderBackend* renderer) {
     // 计算玩家在屏幕上的位置
     SDL_Rect playerRect = {
         x * PLAYER_SIZE,
@@ -30,16 +30,15 @@ void Player::render(SDL_Renderer* renderer) {
     };
     
     // 绘制玩家（红色方块）
-    SDL_SetRenderDrawColor(renderer, 
-                          playerColor.r, 
-                          playerColor.g, 
-                          playerColor.b, 
-                          playerColor.a);
-    SDL_RenderFillRect(renderer, &playerRect);
+    renderer->setDrawColor(playerColor.r, 
+                           playerColor.g, 
+                           playerColor.b, 
+                           playerColor.a);
+    renderer->fillRect(&playerRect);
     
     // 添加边框使玩家更容易看见
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderDrawRect(renderer, &playerRect);
+    renderer->setDrawColor(0, 0, 0, 255);
+    renderer->drawRect(&playerRect);
 }
 
 void Player::setPosition(int newX, int newY) {
@@ -62,12 +61,15 @@ bool Player::move(int dx, int dy, Maze* maze) {
         return false;
     }
     
-    int newX = x + dx;
-    int newY = y + dy;
+    // 只允许单步移动；玩家所在格合法时，通路掩码已经包含了边界和墙的判断
+    int dir = Maze::directionFromDelta(dx, dy);
+    if (dir < 0 || !maze->isValidPosition(x, y)) {
+        return false;
+    }
     
-    if (maze->isValidPosition(newX, newY) && !maze->isWall(newX, newY)) {
-        x = newX;
-        y = newY;
+    if (maze->canMove(x, y, dir)) {
+        x += dx;
+        y += dy;
         return true;
     }
     return false;
@@ -0,0 +1,165 @@
+#include "Profiler.h"
+
+#ifdef MAZE_ENABLE_PROFILER
+
+#include "TextRenderer.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+Profiler::Slot Profiler::ring[Profiler::RING_SIZE];
+std::atomic<uint64_t> Profiler::writeIndex{0};
+uint64_t Profiler::readIndex = 0;
+Profiler::Zone Profiler::zones[Profiler::MAX_ZONES];
+size_t Profiler::zoneCount = 0;
+bool Profiler::overlayVisible = false;
+thread_local int Profiler::suspendDepth = 0;
+
+uint32_t Profiler::currentThread() {
+    // 给每个线程分配一个小编号，trace 里作为 tid
+    static std::atomic<uint32_t> nextThread{1};
+    thread_local uint32_t id = nextThread.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+void Profiler::record(const char* name, Uint64 start, Uint64 end) {
+    if (suspendDepth > 0) return;
+    // 先占位再写入，最后发布序号；任何线程都可以写，缓冲区满了覆盖最旧的样本
+    uint64_t index = writeIndex.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = ring[index & (RING_SIZE - 1)];
+    slot.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.sample = {name, start, end, currentThread()};
+    slot.seq.store(index + 1, std::memory_order_release);
+}
+
+bool Profiler::readSample(uint64_t index, Sample& out) {
+    // 读前读后各检查一次序号，期间被改写的样本直接丢弃
+    const Slot& slot = ring[index & (RING_SIZE - 1)];
+    if (slot.seq.load(std::memory_order_acquire) != index + 1) return false;
+    out = slot.sample;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.seq.load(std::memory_order_relaxed) == index + 1;
+}
+
+Profiler::Zone* Profiler::findZone(const char* name) {
+    // 分区数很少，线性查找即可；名字是字面量，先比指针再比内容
+    for (size_t i = 0; i < zoneCount; i++) {
+        if (zones[i].name == name || std::string(zones[i].name) == name) {
+            return &zones[i];
+        }
+    }
+    if (zoneCount == MAX_ZONES) return nullptr;
+    zones[zoneCount].name = name;
+    return &zones[zoneCount++];
+}
+
+void Profiler::endFrame() {
+    uint64_t end = writeIndex.load(std::memory_order_acquire);
+    if (end - readIndex > RING_SIZE) {
+        // 一帧内的样本超过了缓冲区，只能统计还留着的部分
+        readIndex = end - RING_SIZE;
+    }
+
+    Sample sample;
+    for (; readIndex < end; readIndex++) {
+        if (!readSample(readIndex, sample)) continue;
+        Zone* zone = findZone(sample.name);
+        if (!zone) continue;
+        zone->frameTicks += sample.end - sample.start;
+        zone->touched = true;
+    }
+
+    // 本帧没有出现的分区不计入统计，避免菜单界面把游戏分区拉成 0
+    const double msPerTick = 1000.0 / SDL_GetPerformanceFrequency();
+    for (size_t i = 0; i < zoneCount; i++) {
+        Zone& zone = zones[i];
+        if (!zone.touched) continue;
+        zone.history[zone.historyCursor] = static_cast<float>(zone.frameTicks * msPerTick);
+        zone.historyCursor = (zone.historyCursor + 1) % HISTORY_FRAMES;
+        zone.historyCount = std::min(zone.historyCount + 1, HISTORY_FRAMES);
+        zone.frameTicks = 0;
+        zone.touched = false;
+        if (overlayVisible) {
+            updatePercentiles(zone);
+        }
+    }
+}
+
+void Profiler::updatePercentiles(Zone& zone) {
+    float sorted[HISTORY_FRAMES];
+    std::copy(zone.history, zone.history + zone.historyCount, sorted);
+    std::sort(sorted, sorted + zone.historyCount);
+    zone.p50 = sorted[(zone.historyCount - 1) / 2];
+    zone.p99 = sorted[(zone.historyCount - 1) * 99 / 100];
+}
+
+void Profiler::renderOverlay(RenderBackend* renderer) {
+    if (!overlayVisible || zoneCount == 0) return;
+    // 文字走 TextRenderer，其中的 "text" 分区在绘制期间不记录
+    suspendDepth++;
+
+    const int lineHeight = 16;
+    SDL_Rect panel = {10, 10, 300, 30 + static_cast<int>(zoneCount) * lineHeight};
+    renderer->setDrawBlendMode(SDL_BLENDMODE_BLEND);
+    renderer->setDrawColor(0, 0, 0, 180);
+    renderer->fillRect(&panel);
+
+    SDL_Color header = {255, 215, 0, 255};
+    SDL_Color textColor = {220, 220, 220, 255};
+    TextRenderer::renderText(renderer, "ZONE            P50 / P99 MS", panel.x + 8, panel.y + 6, header, 12);
+
+    char line[64];
+    for (size_t i = 0; i < zoneCount; i++) {
+        const Zone& zone = zones[i];
+        std::snprintf(line, sizeof(line), "%-15.15s %6.2f / %6.2f", zone.name, zone.p50, zone.p99);
+        TextRenderer::renderText(renderer, line, panel.x + 8,
+                                 panel.y + 24 + static_cast<int>(i) * lineHeight, textColor, 12);
+    }
+    suspendDepth--;
+}
+
+bool Profiler::writeTrace(const char* path) {
+    uint64_t end = writeIndex.load(std::memory_order_acquire);
+    uint64_t begin = end > RING_SIZE ? end - RING_SIZE : 0;
+
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Cannot write profiler trace: " << path << std::endl;
+        return false;
+    }
+
+    // 时间戳以缓冲区里最早的样本为零点，单位微秒
+    Sample sample;
+    Uint64 origin = 0;
+    bool haveOrigin = false;
+    for (uint64_t i = begin; i < end; i++) {
+        if (!readSample(i, sample)) continue;
+        if (!haveOrigin || sample.start < origin) {
+            origin = sample.start;
+            haveOrigin = true;
+        }
+    }
+
+    const double usPerTick = 1000000.0 / SDL_GetPerformanceFrequency();
+    file << "{\"traceEvents\":[";
+    bool first = true;
+    char event[256];
+    for (uint64_t i = begin; i < end; i++) {
+        if (!readSample(i, sample)) continue;
+        std::snprintf(event, sizeof(event),
+                      "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+                      first ? "" : ",", sample.name,
+                      (sample.start - origin) * usPerTick,
+                      (sample.end - sample.start) * usPerTick,
+                      sample.thread);
+        file << event;
+        first = false;
+    }
+    file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return file.good();
+}
+
+#endif
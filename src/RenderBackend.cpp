@@ -0,0 +1,218 @@
+#include "RenderBackend.h"
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
+// ---- SDL ----
+
+void SDLRenderBackend::getOutputSize(int* width, int* height) const {
+    SDL_GetRendererOutputSize(renderer, width, height);
+}
+
+void SDLRenderBackend::setDrawColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
+    SDL_SetRenderDrawColor(renderer, r, g, b, a);
+}
+
+void SDLRenderBackend::setDrawBlendMode(SDL_BlendMode mode) {
+    SDL_SetRenderDrawBlendMode(renderer, mode);
+}
+
+void SDLRenderBackend::setTarget(SDL_Texture* texture) {
+    SDL_SetRenderTarget(renderer, texture);
+}
+
+SDL_Texture* SDLRenderBackend::getTarget() const {
+    return SDL_GetRenderTarget(renderer);
+}
+
+void SDLRenderBackend::setClipRect(const SDL_Rect* rect) {
+    SDL_RenderSetClipRect(renderer, rect);
+}
+
+void SDLRenderBackend::clear() {
+    SDL_RenderClear(renderer);
+}
+
+void SDLRenderBackend::fillRect(const SDL_Rect* rect) {
+    SDL_RenderFillRect(renderer, rect);
+}
+
+void SDLRenderBackend::fillRects(const SDL_Rect* rects, int count) {
+    SDL_RenderFillRects(renderer, rects, count);
+}
+
+void SDLRenderBackend::drawRect(const SDL_Rect* rect) {
+    SDL_RenderDrawRect(renderer, rect);
+}
+
+void SDLRenderBackend::drawLine(int x1, int y1, int x2, int y2) {
+    SDL_RenderDrawLine(renderer, x1, y1, x2, y2);
+}
+
+void SDLRenderBackend::drawPoint(int x, int y) {
+    SDL_RenderDrawPoint(renderer, x, y);
+}
+
+void SDLRenderBackend::copy(SDL_Texture* texture, const SDL_Rect* source, const SDL_Rect* dest) {
+    SDL_RenderCopy(renderer, texture, source, dest);
+}
+
+void SDLRenderBackend::copyEx(SDL_Texture* texture, const SDL_Rect* source, const SDL_Rect* dest,
+                              double angle, const SDL_Point* center, SDL_RendererFlip flip) {
+    SDL_RenderCopyEx(renderer, texture, source, dest, angle, center, flip);
+}
+
+void SDLRenderBackend::geometry(SDL_Texture* texture, const SDL_Vertex* vertices, int vertexCount,
+                                const int* indices, int indexCount) {
+    SDL_RenderGeometry(renderer, texture, vertices, vertexCount, indices, indexCount);
+}
+
+void SDLRenderBackend::present() {
+    SDL_RenderPresent(renderer);
+}
+
+// ---- Null ----
+
+void NullRenderBackend::getOutputSize(int* width, int* height) const {
+    if (width) *width = outputWidth;
+    if (height) *height = outputHeight;
+}
+
+// ---- Counting ----
+
+CountingRenderBackend::CountingRenderBackend(std::unique_ptr<RenderBackend> wrapped) :
+    inner(std::move(wrapped)) {}
+
+void CountingRenderBackend::countState(bool changed) {
+    if (changed) {
+        current.stateChanges++;
+    } else {
+        current.redundantStates++;
+    }
+}
+
+long long CountingRenderBackend::areaOf(const SDL_Rect* rect) const {
+    if (rect) {
+        return static_cast<long long>(std::max(rect->w, 0)) * std::max(rect->h, 0);
+    }
+    int width = 0;
+    int height = 0;
+    SDL_Texture* target = inner->getTarget();
+    if (target) {
+        SDL_QueryTexture(target, nullptr, nullptr, &width, &height);
+    } else {
+        inner->getOutputSize(&width, &height);
+    }
+    return static_cast<long long>(width) * height;
+}
+
+void CountingRenderBackend::setDrawColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
+    countState(r != drawColor.r || g != drawColor.g || b != drawColor.b || a != drawColor.a);
+    drawColor = {r, g, b, a};
+    inner->setDrawColor(r, g, b, a);
+}
+
+void CountingRenderBackend::setDrawBlendMode(SDL_BlendMode mode) {
+    countState(mode != blendMode);
+    blendMode = mode;
+    inner->setDrawBlendMode(mode);
+}
+
+void CountingRenderBackend::setTarget(SDL_Texture* texture) {
+    countState(texture != inner->getTarget());
+    inner->setTarget(texture);
+}
+
+void CountingRenderBackend::setClipRect(const SDL_Rect* rect) {
+    bool changed = rect ? (!clipEnabled || rect->x != clipRect.x || rect->y != clipRect.y ||
+                           rect->w != clipRect.w || rect->h != clipRect.h)
+                        : clipEnabled;
+    countState(changed);
+    clipEnabled = rect != nullptr;
+    if (rect) {
+        clipRect = *rect;
+    }
+    inner->setClipRect(rect);
+}
+
+void CountingRenderBackend::clear() {
+    current.drawCalls++;
+    current.pixelsFilled += areaOf(nullptr);
+    inner->clear();
+}
+
+void CountingRenderBackend::fillRect(const SDL_Rect* rect) {
+    current.drawCalls++;
+    current.pixelsFilled += areaOf(rect);
+    inner->fillRect(rect);
+}
+
+void CountingRenderBackend::fillRects(const SDL_Rect* rects, int count) {
+    current.drawCalls++;
+    for (int i = 0; i < count; i++) {
+        current.pixelsFilled += areaOf(&rects[i]);
+    }
+    inner->fillRects(rects, count);
+}
+
+void CountingRenderBackend::drawRect(const SDL_Rect* rect) {
+    current.drawCalls++;
+    if (rect) {
+        current.pixelsFilled += 2LL * (std::max(rect->w, 0) + std::max(rect->h, 0));
+    }
+    inner->drawRect(rect);
+}
+
+void CountingRenderBackend::drawLine(int x1, int y1, int x2, int y2) {
+    current.drawCalls++;
+    current.pixelsFilled += std::max(std::abs(x2 - x1), std::abs(y2 - y1)) + 1;
+    inner->drawLine(x1, y1, x2, y2);
+}
+
+void CountingRenderBackend::drawPoint(int x, int y) {
+    current.drawCalls++;
+    current.pixelsFilled++;
+    inner->drawPoint(x, y);
+}
+
+void CountingRenderBackend::copy(SDL_Texture* texture, const SDL_Rect* source, const SDL_Rect* dest) {
+    current.drawCalls++;
+    current.pixelsFilled += areaOf(dest);
+    inner->copy(texture, source, dest);
+}
+
+void CountingRenderBackend::copyEx(SDL_Texture* texture, const SDL_Rect* source, const SDL_Rect* dest,
+                                   double angle, const SDL_Point* center, SDL_RendererFlip flip) {
+    current.drawCalls++;
+    current.pixelsFilled += areaOf(dest);
+    inner->copyEx(texture, source, dest, angle, center, flip);
+}
+
+void CountingRenderBackend::geometry(SDL_Texture* texture, const SDL_Vertex* vertices, int vertexCount,
+                                     const int* indices, int indexCount) {
+    current.drawCalls++;
+    // 三角形面积之和
+    int triangleVertices = indices ? indexCount : vertexCount;
+    double area = 0.0;
+    for (int i = 0; i + 2 < triangleVertices; i += 3) {
+        const SDL_FPoint& a = vertices[indices ? indices[i] : i].position;
+        const SDL_FPoint& b = vertices[indices ? indices[i + 1] : i + 1].position;
+        const SDL_FPoint& c = vertices[indices ? indices[i + 2] : i + 2].position;
+        area += std::fabs((b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y)) * 0.5;
+    }
+    current.pixelsFilled += static_cast<long long>(area);
+    inner->geometry(texture, vertices, vertexCount, indices, indexCount);
+}
+
+void CountingRenderBackend::present() {
+    inner->present();
+
+    total.drawCalls += current.drawCalls;
+    total.stateChanges += current.stateChanges;
+    total.redundantStates += current.redundantStates;
+    total.pixelsFilled += current.pixelsFilled;
+    frameCount++;
+
+    lastFrame = current;
+    current = RenderStats();
+}
@@ -0,0 +1,184 @@
+#include "SaveWorker.h"
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+#ifdef _WIN32
+    // 写入并 _commit 落盘，append 为 true 时追加到末尾
+    bool writeDurably(const std::string& path, const std::string& data, bool append) {
+        int flags = _O_WRONLY | _O_CREAT | _O_BINARY | (append ? _O_APPEND : _O_TRUNC);
+        int fd = _open(path.c_str(), flags, _S_IREAD | _S_IWRITE);
+        if (fd < 0) return false;
+        size_t written = 0;
+        bool ok = true;
+        while (ok && written < data.size()) {
+            int n = _write(fd, data.data() + written, static_cast<unsigned int>(data.size() - written));
+            ok = n > 0;
+            if (ok) written += static_cast<size_t>(n);
+        }
+        ok = ok && _commit(fd) == 0;
+        return _close(fd) == 0 && ok;
+    }
+
+    // Windows 上 rename 不能覆盖已存在的文件，改用 MoveFileExW
+    bool replaceFile(const std::filesystem::path& from, const std::filesystem::path& to) {
+        return MoveFileExW(from.wstring().c_str(), to.wstring().c_str(),
+                           MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+    }
+#else
+    bool writeDurably(const std::string& path, const std::string& data, bool append) {
+        int flags = O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC);
+        int fd = ::open(path.c_str(), flags, 0644);
+        if (fd < 0) return false;
+        size_t written = 0;
+        bool ok = true;
+        while (ok && written < data.size()) {
+            ssize_t n = ::write(fd, data.data() + written, data.size() - written);
+            if (n < 0 && errno == EINTR) continue;
+            ok = n >= 0;
+            if (ok) written += static_cast<size_t>(n);
+        }
+        ok = ok && ::fsync(fd) == 0;
+        return ::close(fd) == 0 && ok;
+    }
+
+    // rename 之后同步所在目录，目录项本身也落盘
+    bool replaceFile(const std::filesystem::path& from, const std::filesystem::path& to) {
+        if (std::rename(from.c_str(), to.c_str()) != 0) return false;
+        std::filesystem::path dir = to.parent_path();
+        if (dir.empty()) dir = ".";
+        int fd = ::open(dir.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            ::fsync(fd);
+            ::close(fd);
+        }
+        return true;
+    }
+#endif
+
+    void ensureParentDirectory(const std::filesystem::path& file) {
+        std::filesystem::path dir = file.parent_path();
+        if (dir.empty()) return;
+        std::error_code error;
+        std::filesystem::create_directories(dir, error);
+        if (error) {
+            std::cerr << "Cannot create directory " << dir << ": " << error.message() << std::endl;
+        }
+    }
+}
+
+SaveWorker::SaveWorker() :
+    running(false)
+{}
+
+SaveWorker::~SaveWorker() {
+    stop();
+}
+
+void SaveWorker::start() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (running) return;
+    running = true;
+    worker = std::thread(&SaveWorker::workerLoop, this);
+}
+
+void SaveWorker::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) return;
+        running = false;
+    }
+    wake.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void SaveWorker::requestWrite(const std::string& path, std::string data) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = pendingWrites.find(path);
+        if (it != pendingWrites.end()) {
+            it->second = std::move(data);
+        } else {
+            pendingWrites.emplace(path, std::move(data));
+        }
+    }
+    wake.notify_one();
+}
+
+void SaveWorker::requestAppend(const std::string& path, std::string data) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pendingAppends.emplace_back(path, std::move(data));
+    }
+    wake.notify_one();
+}
+
+void SaveWorker::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] {
+            return !running || !pendingWrites.empty() || !pendingAppends.empty();
+        });
+        if (pendingWrites.empty() && pendingAppends.empty()) {
+            break; // 已停止且没有剩余请求
+        }
+
+        // 运行中先等一会，把紧接着到来的请求合并进来；停止时立即写出
+        if (running) {
+            wake.wait_for(lock, std::chrono::milliseconds(COALESCE_DELAY_MS), [this] { return !running; });
+        }
+
+        std::map<std::string, std::string> writes;
+        std::vector<std::pair<std::string, std::string>> appends;
+        writes.swap(pendingWrites);
+        appends.swap(pendingAppends);
+
+        // 磁盘操作不持锁，主线程随时可以继续提交
+        lock.unlock();
+        for (const auto& append : appends) {
+            appendDurably(append.first, append.second);
+        }
+        for (const auto& write : writes) {
+            writeAtomically(write.first, write.second);
+        }
+        lock.lock();
+    }
+}
+
+bool SaveWorker::writeAtomically(const std::string& path, const std::string& data) {
+    std::filesystem::path target(path);
+    ensureParentDirectory(target);
+    std::filesystem::path tempPath(path + ".tmp");
+
+    if (!writeDurably(tempPath.string(), data, false) || !replaceFile(tempPath, target)) {
+        std::cerr << "Failed to save " << path << ": " << std::strerror(errno) << std::endl;
+        std::remove(tempPath.string().c_str());
+        return false;
+    }
+    return true;
+}
+
+bool SaveWorker::appendDurably(const std::string& path, const std::string& data) {
+    ensureParentDirectory(std::filesystem::path(path));
+    if (!writeDurably(path, data, true)) {
+        std::cerr << "Failed to append to " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -1,37 +1,219 @@
 #include "TextRenderer.h"
-// #include <iostream>
+#include "Profiler.h"
+#include <algorithm>
+#include <iostream>
 
-TTF_Font* TextRenderer::font = nullptr;
+std::map<int, TextRenderer::FontAtlas> TextRenderer::atlases;
+std::string TextRenderer::fontPath;
 const char* TextRenderer::FONT_PATH = "assets/fonts/Arial.ttf";
+std::vector<SDL_Vertex> TextRenderer::vertices;
+std::vector<int> TextRenderer::indices;
 
 bool TextRenderer::init() {
-    font = TTF_OpenFont(FONT_PATH, 24);
-    if (!font) {
-        // 尝试系统字体
-        font = TTF_OpenFont("/System/Library/Fonts/Supplemental/Arial.ttf", 24);
+    // 先确定可用的字体文件，各字号之后按需打开
+    const char* candidates[] = {
+        FONT_PATH,
+        "/System/Library/Fonts/Supplemental/Arial.ttf"  // 尝试系统字体
+    };
+    for (const char* path : candidates) {
+        TTF_Font* probe = TTF_OpenFont(path, 24);
+        if (probe) {
+            fontPath = path;
+            TTF_SetFontKerning(probe, 1);
+            atlases[24].font = probe;
+            return true;
+        }
+    }
+    return false;
+}
+
+TextRenderer::FontAtlas* TextRenderer::getAtlas(int fontSize) {
+    if (fontPath.empty() || fontSize <= 0) return nullptr;
+
+    FontAtlas& atlas = atlases[fontSize];
+    if (!atlas.font) {
+        atlas.font = TTF_OpenFont(fontPath.c_str(), fontSize);
+        if (!atlas.font) {
+            std::cerr << "Failed to open font at size " << fontSize << ": " << TTF_GetError() << std::endl;
+            atlases.erase(fontSize);
+            return nullptr;
+        }
+        TTF_SetFontKerning(atlas.font, 1);
     }
-    return font != nullptr;
+
+    // 字形度量只依赖字体，首次使用时填好
+    if (!atlas.metricsReady) {
+        for (int i = 0; i < GLYPH_COUNT; i++) {
+            int advance = 0;
+            TTF_GlyphMetrics(atlas.font, static_cast<Uint16>(FIRST_GLYPH + i),
+                             nullptr, nullptr, nullptr, nullptr, &advance);
+            atlas.glyphs[i].advance = advance;
+        }
+        atlas.metricsReady = true;
+    }
+    return &atlas;
 }
 
-void TextRenderer::renderText(SDL_Renderer* renderer, const std::string& text, 
+bool TextRenderer::buildTexture(RenderBackend* renderer, FontAtlas& atlas) {
+    // 字形用白色光栅化，绘制时用顶点颜色调制成目标颜色
+    SDL_Color white = {255, 255, 255, 255};
+    SDL_Surface* glyphSurfaces[GLYPH_COUNT] = {};
+
+    // 简单的按行装箱，图集宽度固定
+    const int ATLAS_WIDTH = 512;
+    int penX = 0;
+    int penY = 0;
+    int rowHeight = 0;
+    for (int i = 0; i < GLYPH_COUNT; i++) {
+        SDL_Surface* surface = TTF_RenderGlyph_Blended(atlas.font, static_cast<Uint16>(FIRST_GLYPH + i), white);
+        glyphSurfaces[i] = surface;
+        if (!surface) {
+            atlas.glyphs[i].source = {0, 0, 0, 0};
+            continue;
+        }
+        if (penX + surface->w > ATLAS_WIDTH) {
+            penX = 0;
+            penY += rowHeight + 1;
+            rowHeight = 0;
+        }
+        atlas.glyphs[i].source = {penX, penY, surface->w, surface->h};
+        penX += surface->w + 1;
+        rowHeight = std::max(rowHeight, surface->h);
+    }
+    int atlasHeight = penY + rowHeight;
+
+    SDL_Surface* atlasSurface = atlasHeight > 0 ?
+        SDL_CreateRGBSurfaceWithFormat(0, ATLAS_WIDTH, atlasHeight, 32, SDL_PIXELFORMAT_RGBA32) : nullptr;
+    if (atlasSurface) {
+        SDL_FillRect(atlasSurface, nullptr, 0);
+        for (int i = 0; i < GLYPH_COUNT; i++) {
+            if (!glyphSurfaces[i]) continue;
+            // 直接拷贝像素（含透明度），不与透明背景混合
+            SDL_SetSurfaceBlendMode(glyphSurfaces[i], SDL_BLENDMODE_NONE);
+            SDL_Rect dest = atlas.glyphs[i].source;
+            SDL_BlitSurface(glyphSurfaces[i], nullptr, atlasSurface, &dest);
+        }
+        atlas.texture = SDL_CreateTextureFromSurface(renderer->getSDLRenderer(), atlasSurface);
+        SDL_FreeSurface(atlasSurface);
+    }
+    for (SDL_Surface* surface : glyphSurfaces) {
+        if (surface) SDL_FreeSurface(surface);
+    }
+
+    if (!atlas.texture) {
+        std::cerr << "Failed to create glyph atlas: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    SDL_SetTextureBlendMode(atlas.texture, SDL_BLENDMODE_BLEND);
+    atlas.owner = renderer->getSDLRenderer();
+    atlas.textureWidth = ATLAS_WIDTH;
+    atlas.textureHeight = atlasHeight;
+    return true;
+}
+
+const TextRenderer::Glyph* TextRenderer::findGlyph(const FontAtlas& atlas, char c) {
+    int code = static_cast<unsigned char>(c);
+    if (code < FIRST_GLYPH || code > LAST_GLYPH) {
+        // 图集外的字符按问号处理
+        code = '?';
+    }
+    return &atlas.glyphs[code - FIRST_GLYPH];
+}
+
+void TextRenderer::renderText(RenderBackend* renderer, const std::string& text,
                             int x, int y, SDL_Color color, int fontSize) {
-    if (!font) return;
-    
-    SDL_Surface* surface = TTF_RenderText_Blended(font, text.c_str(), color);
-    if (surface) {
-        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-        if (texture) {
-            SDL_Rect rect = {x, y, surface->w, surface->h};
-            SDL_RenderCopy(renderer, texture, nullptr, &rect);
-            SDL_DestroyTexture(texture);
+    // 没有 SDL 渲染器（空后端）时建不出图集，直接跳过
+    if (text.empty() || !renderer->getSDLRenderer()) return;
+    PROFILE_SCOPE("text");
+
+    FontAtlas* atlas = getAtlas(fontSize);
+    if (!atlas) return;
+
+    // 图集纹理属于创建它的渲染器
+    if (atlas->texture && atlas->owner != renderer->getSDLRenderer()) {
+        SDL_DestroyTexture(atlas->texture);
+        atlas->texture = nullptr;
+    }
+    if (!atlas->texture && !buildTexture(renderer, *atlas)) return;
+
+    vertices.clear();
+    indices.clear();
+
+    float invWidth = 1.0f / atlas->textureWidth;
+    float invHeight = 1.0f / atlas->textureHeight;
+    int penX = x;
+    Uint16 previous = 0;
+    for (char c : text) {
+        const Glyph* glyph = findGlyph(*atlas, c);
+        Uint16 code = static_cast<Uint16>(FIRST_GLYPH + (glyph - atlas->glyphs));
+        if (previous) {
+            penX += TTF_GetFontKerningSizeGlyphs(atlas->font, previous, code);
+        }
+        previous = code;
+
+        const SDL_Rect& src = glyph->source;
+        if (src.w > 0 && src.h > 0) {
+            float left = static_cast<float>(penX);
+            float top = static_cast<float>(y);
+            float right = left + src.w;
+            float bottom = top + src.h;
+            float u0 = src.x * invWidth;
+            float v0 = src.y * invHeight;
+            float u1 = (src.x + src.w) * invWidth;
+            float v1 = (src.y + src.h) * invHeight;
+
+            int base = static_cast<int>(vertices.size());
+            vertices.push_back({{left, top}, color, {u0, v0}});
+            vertices.push_back({{right, top}, color, {u1, v0}});
+            vertices.push_back({{right, bottom}, color, {u1, v1}});
+            vertices.push_back({{left, bottom}, color, {u0, v1}});
+            indices.insert(indices.end(), {base, base + 1, base + 2, base, base + 2, base + 3});
+        }
+        penX += glyph->advance;
+    }
+
+    if (!vertices.empty()) {
+        renderer->geometry(atlas->texture,
+                           vertices.data(), static_cast<int>(vertices.size()),
+                           indices.data(), static_cast<int>(indices.size()));
+    }
+}
+
+int TextRenderer::measureText(const std::string& text, int fontSize) {
+    FontAtlas* atlas = getAtlas(fontSize);
+    if (!atlas) return 0;
+
+    int width = 0;
+    Uint16 previous = 0;
+    for (char c : text) {
+        const Glyph* glyph = findGlyph(*atlas, c);
+        Uint16 code = static_cast<Uint16>(FIRST_GLYPH + (glyph - atlas->glyphs));
+        if (previous) {
+            width += TTF_GetFontKerningSizeGlyphs(atlas->font, previous, code);
+        }
+        previous = code;
+        width += glyph->advance;
+    }
+    return width;
+}
+
+void TextRenderer::releaseTextures() {
+    for (auto& entry : atlases) {
+        if (entry.second.texture) {
+            SDL_DestroyTexture(entry.second.texture);
+            entry.second.texture = nullptr;
+            entry.second.owner = nullptr;
         }
-        SDL_FreeSurface(surface);
     }
 }
 
 void TextRenderer::cleanup() {
-    if (font) {
-        TTF_CloseFont(font);
-        font = nullptr;
+    releaseTextures();
+    for (auto& entry : atlases) {
+        if (entry.second.font) {
+            TTF_CloseFont(entry.second.font);
+        }
     }
-} 
\ No newline at end of file
+    atlases.clear();
+    fontPath.clear();
+}
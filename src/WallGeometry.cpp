@@ -0,0 +1,106 @@
+#include "WallGeometry.h"
+#include <algorithm>
+
+namespace {
+    // 格子类别；终点单独绘制，不参与合并
+    constexpr uint8_t KIND_FLOOR = 0;
+    constexpr uint8_t KIND_WALL = 1;
+    constexpr uint8_t KIND_GOAL = 2;
+}
+
+void WallGeometry::build(const Maze& maze) {
+    int width = maze.getWidth();
+    int height = maze.getHeight();
+
+    kinds.resize(static_cast<size_t>(width) * height);
+    for (int y = 0; y < height; y++) {
+        int index = maze.toIndex(0, y);
+        for (int x = 0; x < width; x++, index++) {
+            uint8_t kind = maze.isWallAt(index) ? KIND_WALL :
+                           maze.isGoal(x, y) ? KIND_GOAL : KIND_FLOOR;
+            kinds[static_cast<size_t>(y) * width + x] = kind;
+        }
+    }
+
+    mergeBest(width, height, KIND_WALL, wallRects);
+    mergeBest(width, height, KIND_FLOOR, floorRects);
+}
+
+void WallGeometry::mergeBest(int width, int height, uint8_t kind, std::vector<CellRect>& out) {
+    // 两种扫描顺序各做一次，取矩形更少的结果
+    mergeCells(width, height, kind, true, out);
+    mergeCells(width, height, kind, false, candidate);
+    if (candidate.size() < out.size()) {
+        out.swap(candidate);
+    }
+}
+
+void WallGeometry::mergeCells(int width, int height, uint8_t kind, bool rowsFirst,
+                              std::vector<CellRect>& out) {
+    out.clear();
+    covered.assign(kinds.size(), 0);
+
+    auto matches = [&](int x, int y) {
+        size_t i = static_cast<size_t>(y) * width + x;
+        return kinds[i] == kind && !covered[i];
+    };
+
+    // 主方向是扫描和首先扩展的方向，次方向随后整段扩展
+    int majorCount = rowsFirst ? height : width;
+    int minorCount = rowsFirst ? width : height;
+    for (int major = 0; major < majorCount; major++) {
+        for (int minor = 0; minor < minorCount; minor++) {
+            int x = rowsFirst ? minor : major;
+            int y = rowsFirst ? major : minor;
+            if (!matches(x, y)) continue;
+
+            // 沿主方向尽量延长
+            int length = 1;
+            while (minor + length < minorCount &&
+                   (rowsFirst ? matches(x + length, y) : matches(x, y + length))) {
+                length++;
+            }
+
+            // 整段向次方向扩展，直到某一段不完全匹配
+            int span = 1;
+            while (major + span < majorCount) {
+                bool full = true;
+                for (int k = 0; k < length && full; k++) {
+                    full = rowsFirst ? matches(x + k, y + span) : matches(x + span, y + k);
+                }
+                if (!full) break;
+                span++;
+            }
+
+            CellRect rect = rowsFirst ? CellRect{x, y, length, span} : CellRect{x, y, span, length};
+            for (int ry = rect.y; ry < rect.y + rect.h; ry++) {
+                std::fill_n(covered.begin() + static_cast<size_t>(ry) * width + rect.x, rect.w, 1);
+            }
+            out.push_back(rect);
+            minor += length - 1;
+        }
+    }
+}
+
+void WallGeometry::toPixels(const std::vector<CellRect>& cells, float offsetX, float offsetY,
+                            float cellSize, std::vector<SDL_Rect>& out) {
+    out.clear();
+    for (const CellRect& cell : cells) {
+        // 用左上角和右下角分别取整，相邻矩形的边严格对齐
+        int left = static_cast<int>(offsetX + cell.x * cellSize);
+        int top = static_cast<int>(offsetY + cell.y * cellSize);
+        int right = static_cast<int>(offsetX + (cell.x + cell.w) * cellSize);
+        int bottom = static_cast<int>(offsetY + (cell.y + cell.h) * cellSize);
+        out.push_back({left, top, right - left, bottom - top});
+    }
+}
+
+void WallGeometry::buildShadows(const std::vector<SDL_Rect>& walls, std::vector<SDL_Rect>& out) {
+    out.clear();
+    for (const SDL_Rect& rect : walls) {
+        // 右侧阴影
+        out.push_back({rect.x + rect.w, rect.y + 2, 2, rect.h - 2});
+        // 底部阴影
+        out.push_back({rect.x + 2, rect.y + rect.h, rect.w - 2, 2});
+    }
+}
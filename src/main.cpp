@@ -1,8 +1,54 @@
 #include "Game.h"
 #include <iostream>
+#include <string>
+#include <cstdlib>
+#include <sstream>
 
 int main(int argc, char* argv[]) {
     Game game;
+    bool headless = false;
+    int frames = 300;
+    
+    // 帧率控制：默认跟随 VSync，--uncapped 不限帧，--fps=N 按 N 帧限速
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--vsync") {
+            game.setFramePacing(FramePacing::VSYNC);
+        } else if (arg == "--uncapped") {
+            game.setFramePacing(FramePacing::UNCAPPED);
+        } else if (arg.rfind("--fps=", 0) == 0) {
+            game.setFramePacing(FramePacing::CAPPED, std::atoi(arg.c_str() + 6));
+        } else if (arg == "--low-power") {
+            game.setLowPowerMode(true);
+        } else if (arg == "--render=count") {
+            game.setRenderBackend(RenderBackendType::COUNTING);
+        } else if (arg == "--render=null") {
+            game.setRenderBackend(RenderBackendType::NULL_OUTPUT);
+        } else if (arg == "--headless") {
+            headless = true;
+        } else if (arg.rfind("--frames=", 0) == 0) {
+            frames = std::atoi(arg.c_str() + 9);
+        } else if (arg.rfind("--dump=", 0) == 0) {
+            // 逗号分隔的帧号列表
+            std::stringstream list(arg.substr(7));
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                game.addFrameDump(std::atoi(item.c_str()));
+            }
+        } else if (arg.rfind("--level=", 0) == 0) {
+            game.setStartLevel(std::atoi(arg.c_str() + 8));
+        } else if (arg.rfind("--record=", 0) == 0) {
+            game.recordInput(arg.substr(9));
+        } else if (arg.rfind("--replay=", 0) == 0) {
+            game.replayInput(arg.substr(9), false);
+        } else if (arg.rfind("--replay-fast=", 0) == 0) {
+            game.replayInput(arg.substr(14), true);
+        }
+    }
+    
+    if (headless) {
+        game.setHeadless(frames);
+    }
     
     if (!game.init()) {
         std::cerr << "游戏初始化失败！" << std::endl;
@@ -12,4 +58,4 @@ int main(int argc, char* argv[]) {
     game.run();
     
     return 0;
-}
\ No newline at end of file
+}